@@ -0,0 +1,70 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/// @brief helpers shared by the benchmarks in this folder
+/// @note every benchmark is its own executable built with "make bench" against the release objects of the framework
+class Bench
+{
+public:
+    /// @brief runs the function the given number of times
+    /// @returns the fastest run in milliseconds
+    template <typename Function>
+    static inline double time(const Function& function, int runs = 5)
+    {
+        double best = 1e300;
+        for (int i = 0; i < runs; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            function();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    /// @brief prints the time and the time per operation
+    static inline void print(const std::string& name, double milliseconds, std::size_t operations)
+    {
+        std::printf("%-48s %10.3f ms %10.2f ns/op\n", name.c_str(), milliseconds, milliseconds * 1e6 / (double)std::max<std::size_t>(operations, 1));
+    }
+
+    /// @brief stops the compiler from removing a result that is never used
+    template <typename T>
+    static inline void keep(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /// @brief a small fast random number generator so every benchmark uses the same sequence
+    class Random
+    {
+    public:
+        inline Random(std::uint64_t seed = 0x9E3779B97F4A7C15ull) : m_state(seed) {}
+
+        inline std::uint64_t next()
+        {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 7;
+            m_state ^= m_state << 17;
+            return m_state;
+        }
+
+        /// @returns a number in [0, max)
+        inline std::size_t next(std::size_t max)
+        {
+            return (std::size_t)(next() % max);
+        }
+
+    private:
+        std::uint64_t m_state;
+    };
+};
+
+#endif
@@ -0,0 +1,325 @@
+// counts cache misses (linux perf counters) of the per frame passes over a 100k object update-and-draw scene
+// also compares the hot fields first object layout with the old layout where the events came first
+// the layout comparison uses plain structs with the size of an Object, the scene passes are only meaningful in a full build (not with stand-in graphics)
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Bench.hpp"
+#include "ObjectManager.hpp"
+#include "TransformStore.hpp"
+#include "UpdateInterface.hpp"
+#include "UpdateManager.hpp"
+#include "Graphics/Renderer.hpp"
+
+/// @brief counts cache misses of this thread while running a function
+/// @note only linux is supported, on other platforms (or if the counters are not available) only the time is measured
+class CacheCounters
+{
+public:
+    struct Result
+    {
+        double milliseconds = 0;
+        std::uint64_t cacheMisses = 0;
+        std::uint64_t cacheReferences = 0;
+        std::uint64_t l1dMisses = 0;
+    };
+
+    inline CacheCounters()
+    {
+#ifdef __linux__
+        m_cacheMisses = m_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        m_cacheReferences = m_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+        m_l1dMisses = m_open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+        m_error = "only supported on linux";
+#endif
+    }
+
+    inline ~CacheCounters()
+    {
+#ifdef __linux__
+        for (int fd: {m_cacheMisses, m_cacheReferences, m_l1dMisses})
+        {
+            if (fd != -1)
+                close(fd);
+        }
+#endif
+    }
+
+    CacheCounters(const CacheCounters&) = delete;
+    void operator=(const CacheCounters&) = delete;
+
+    /// @returns true if the last level cache miss counter could be opened
+    inline bool isAvailable() const
+    {
+        return m_cacheMisses != -1;
+    }
+
+    /// @returns why the counters are not available
+    inline const std::string& getError() const
+    {
+        return m_error;
+    }
+
+    /// @brief runs the function the given number of times
+    /// @returns the counts of the fastest run
+    template <typename Function>
+    inline Result measure(const Function& function, int runs = 5)
+    {
+        Result best;
+        best.milliseconds = 1e300;
+        for (int i = 0; i < runs; i++)
+        {
+            m_reset();
+            auto start = std::chrono::steady_clock::now();
+            m_enable(true);
+            function();
+            m_enable(false);
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (milliseconds < best.milliseconds)
+            {
+                best.milliseconds = milliseconds;
+                best.cacheMisses = m_read(m_cacheMisses);
+                best.cacheReferences = m_read(m_cacheReferences);
+                best.l1dMisses = m_read(m_l1dMisses);
+            }
+        }
+        return best;
+    }
+
+    /// @brief prints the time and the counts per object
+    inline void print(const std::string& name, const Result& result, std::size_t objects) const
+    {
+        Bench::print(name, result.milliseconds, objects);
+        if (!isAvailable())
+            return;
+        double count = (double)std::max<std::size_t>(objects, 1);
+        std::printf("%-48s %10.3f LLC misses/op %8.3f LLC refs/op %8.3f L1D misses/op\n", "", (double)result.cacheMisses / count,
+                    (double)result.cacheReferences / count, (double)result.l1dMisses / count);
+    }
+
+private:
+#ifdef __linux__
+    inline int m_open(std::uint32_t type, std::uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        // user space only so it works with the default perf_event_paranoid setting
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd == -1 && m_error.empty())
+            m_error = std::strerror(errno);
+        return fd;
+    }
+
+    inline void m_reset()
+    {
+        for (int fd: {m_cacheMisses, m_cacheReferences, m_l1dMisses})
+        {
+            if (fd != -1)
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        }
+    }
+
+    inline void m_enable(bool enable)
+    {
+        for (int fd: {m_cacheMisses, m_cacheReferences, m_l1dMisses})
+        {
+            if (fd != -1)
+                ioctl(fd, enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    inline std::uint64_t m_read(int fd) const
+    {
+        std::uint64_t count = 0;
+        if (fd == -1 || ::read(fd, &count, sizeof(count)) != sizeof(count))
+            return 0;
+        return count;
+    }
+#else
+    inline void m_reset() {}
+    inline void m_enable(bool) {}
+    inline std::uint64_t m_read(int) const { return 0; }
+#endif
+
+    int m_cacheMisses = -1;
+    int m_cacheReferences = -1;
+    int m_l1dMisses = -1;
+    std::string m_error;
+};
+
+/// @brief a drawn object that moves every update
+class Mover : public virtual Object, public Renderer<sf::RectangleShape>, public UpdateInterface
+{
+public:
+    inline void Update(float deltaTime) override
+    {
+        move(deltaTime, 0.f);
+    }
+};
+
+/// @brief the fields of Object read every frame (enabled, destroy queued, transform index, cached global transform, type info, parent, id)
+struct HotFields
+{
+    bool enabledInHierarchy = true;
+    bool destroyQueued = false;
+    bool globalTransformDirty = false;
+    std::uint32_t transformIndex = 0;
+    float position[2] = {};
+    float rotation[2] = {1.f, 0.f};
+    void* typeInfo = nullptr;
+    void* parent = nullptr;
+    std::uint64_t id = 0;
+};
+
+/// @brief the current layout, the hot fields are declared right after the vtable pointer
+struct HotFirst
+{
+    void* vtable = nullptr;
+    HotFields hot;
+    void* events[12] = {};
+    char cold[sizeof(Object) - sizeof(void*) * 13 - sizeof(HotFields)];
+};
+
+/// @brief the layout before the split, the 12 event pointers came before the hot fields
+struct EventsFirst
+{
+    void* vtable = nullptr;
+    void* events[12] = {};
+    HotFields hot;
+    char cold[sizeof(Object) - sizeof(void*) * 13 - sizeof(HotFields)];
+};
+
+static_assert(sizeof(HotFirst) == sizeof(Object) && sizeof(EventsFirst) == sizeof(Object), "the layouts should be the size of an Object");
+
+/// @brief reads what the draw pass reads from each object (the vtable pointer, the enabled flag, and the cached global transform)
+/// @param order the index of each object in the order they are visited
+template <typename Layout>
+static CacheCounters::Result measureLayout(CacheCounters& counters, const std::vector<std::uint32_t>& order)
+{
+    std::unique_ptr<Layout[]> objects(new Layout[order.size()]);
+    for (std::size_t i = 0; i < order.size(); i++)
+    {
+        objects[i].hot.position[0] = (float)i;
+        objects[i].hot.enabledInHierarchy = i % 16 != 0;
+    }
+    return counters.measure([&]()
+    {
+        float sum = 0;
+        for (std::uint32_t i: order)
+        {
+            const Layout& object = objects[i];
+            Bench::keep(object.vtable);
+            if (object.hot.enabledInHierarchy && !object.hot.globalTransformDirty)
+                sum += object.hot.position[0] + object.hot.position[1] + object.hot.rotation[0];
+        }
+        Bench::keep(sum);
+    });
+}
+
+/// @brief prints both layouts visited in the given order
+static void compareLayouts(CacheCounters& counters, const std::string& name, const std::vector<std::uint32_t>& order)
+{
+    CacheCounters::Result hotFirst = measureLayout<HotFirst>(counters, order);
+    CacheCounters::Result eventsFirst = measureLayout<EventsFirst>(counters, order);
+    counters.print("layout, " + name + ": hot fields first (now)", hotFirst, order.size());
+    counters.print("layout, " + name + ": events first (before)", eventsFirst, order.size());
+    std::printf("%-48s %10.2fx\n", "speedup", eventsFirst.milliseconds / hotFirst.milliseconds);
+    if (counters.isAvailable() && hotFirst.cacheMisses > 0)
+        std::printf("%-48s %10.2fx\n", "cache miss reduction", (double)eventsFirst.cacheMisses / (double)hotFirst.cacheMisses);
+    std::printf("\n");
+}
+
+int main()
+{
+    constexpr std::size_t OBJECTS = 100000;
+
+    CacheCounters counters;
+    if (counters.isAvailable())
+        std::printf("perf counters: last level cache misses, last level cache references, L1D read misses (user space only)\n");
+    else
+        std::printf("perf counters are not available (%s), only times are measured\n", counters.getError().c_str());
+    std::printf("%zu objects (Mover = Renderer<sf::RectangleShape> + UpdateInterface), sizeof(Object) = %zu, sizeof(Mover) = %zu\n", OBJECTS, sizeof(Object), sizeof(Mover));
+    // the layout difference only shows once the objects do not fit in the last level cache
+    std::printf("the objects take %.1f MiB (Mover) and %.1f MiB (Object sized layouts)\n\n", (double)(OBJECTS * sizeof(Mover)) / 1048576.0, (double)(OBJECTS * sizeof(Object)) / 1048576.0);
+
+    std::vector<DrawableObject*> drawables;
+    drawables.reserve(OBJECTS);
+    for (std::size_t i = 0; i < OBJECTS; i++)
+    {
+        Mover* mover = Object::create<Mover>();
+        mover->setPosition((float)(i % 1000), (float)(i / 1000));
+        drawables.emplace_back(mover);
+    }
+    // drawables are drawn in pointer order (see _drawableComp)
+    std::sort(drawables.begin(), drawables.end());
+    UpdateManager::Start();
+
+    CacheCounters::Result update = counters.measure([]()
+    {
+        UpdateManager::Update(1.f / 60.f);
+    });
+    counters.print("scene: UpdateManager::Update", update, OBJECTS);
+
+    CacheCounters::Result transforms = counters.measure([]()
+    {
+        UpdateManager::Update(1.f / 60.f);
+        TransformStore::updateGlobalTransforms();
+    });
+    transforms.milliseconds -= update.milliseconds;
+    transforms.cacheMisses -= std::min(transforms.cacheMisses, update.cacheMisses);
+    transforms.cacheReferences -= std::min(transforms.cacheReferences, update.cacheReferences);
+    transforms.l1dMisses -= std::min(transforms.l1dMisses, update.l1dMisses);
+    counters.print("scene: updateGlobalTransforms (after update)", transforms, OBJECTS);
+
+    // what DrawableManager::draw reads from each drawable before drawing its shape
+    CacheCounters::Result draw = counters.measure([&]()
+    {
+        float sum = 0;
+        for (DrawableObject* drawable: drawables)
+        {
+            if (drawable->isEnabled())
+                sum += drawable->getGlobalTransform().position.x;
+        }
+        Bench::keep(sum);
+    });
+    counters.print("scene: draw pass (enabled + global transform)", draw, OBJECTS);
+    std::printf("\n");
+
+    ObjectManager::destroyAllObjects();
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+
+    // the same reads on plain structs with the size of an Object so only the field order differs
+    // in memory order the prefetcher hides most of the difference, objects are visited out of order once they are reparented or recycled by the pools
+    std::vector<std::uint32_t> order(OBJECTS);
+    for (std::uint32_t i = 0; i < OBJECTS; i++)
+    {
+        order[i] = i;
+    }
+    compareLayouts(counters, "memory order", order);
+    Bench::Random random;
+    for (std::size_t i = order.size(); i > 1; i--)
+    {
+        std::swap(order[i - 1], order[random.next(i)]);
+    }
+    compareLayouts(counters, "shuffled", order);
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+// compares the frame times of loading a large world all at once with loading it incrementally and streaming it around a moving camera
+
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "LevelStreamer.hpp"
+#include "ObjectManager.hpp"
+
+/// @brief the number of chunks along each side of the world
+constexpr int CHUNKS = 64;
+constexpr float CHUNK_SIZE = 10.f;
+/// @brief each chunk has one root with this many children
+constexpr int CHILDREN = 24;
+/// @brief the time budget given to the incremental loads each frame
+constexpr float BUDGET = 0.002f;
+/// @brief the frames are spaced out like a 60 fps game so the thread pool has time to decode
+constexpr std::chrono::microseconds FRAME_TIME(16667);
+
+/// @brief a small object with some custom data like most game objects
+class Prop : public virtual Object
+{
+public:
+    inline void writeSnapshot(SnapshotWriter& writer) const { writer.write<std::uint32_t>(m_health); }
+    inline void readSnapshot(SnapshotReader& reader) { m_health = reader.read<std::uint32_t>(); }
+
+    std::uint32_t m_health = 100;
+};
+
+static void clearObjects()
+{
+    ObjectManager::destroyAllObjects();
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+}
+
+/// @brief prints the number of frames, the mean, the 99th percentile, and the worst frame time
+static void printFrames(const char* name, std::vector<double> frames)
+{
+    std::sort(frames.begin(), frames.end());
+    double total = 0;
+    for (double frame: frames)
+    {
+        total += frame;
+    }
+    double p99 = frames[std::min(frames.size() - 1, frames.size() * 99 / 100)];
+    std::printf("%-48s %6zu frames  mean %8.3f ms  p99 %8.3f ms  max %8.3f ms\n", name, frames.size(), total / (double)frames.size(), p99, frames.back());
+}
+
+template <typename Function>
+static double frame(const Function& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    SceneSnapshot::registerType<Prop>("Prop");
+
+    std::vector<Object*> roots;
+    roots.reserve(CHUNKS * CHUNKS);
+    for (int x = 0; x < CHUNKS; x++)
+    {
+        for (int y = 0; y < CHUNKS; y++)
+        {
+            Prop* root = new Prop();
+            root->setPosition((x + 0.5f) * CHUNK_SIZE, (y + 0.5f) * CHUNK_SIZE);
+            for (int i = 0; i < CHILDREN; i++)
+            {
+                Prop* child = new Prop();
+                child->setParent(root);
+                child->setPosition(root->getPosition() + Vector2((float)(i % 5), (float)(i / 5)));
+            }
+            roots.emplace_back(root);
+        }
+    }
+    const std::size_t objects = (std::size_t)ObjectManager::getNumberOfObjects();
+
+    std::stringstream stream;
+    SceneSnapshot::save(stream, roots);
+    const std::string snapshot = stream.str();
+    const std::string levelPath = (std::filesystem::temp_directory_path() / "LevelStreamingBench.level").string();
+    if (!LevelStreamer::writeLevel(levelPath, CHUNK_SIZE, roots))
+    {
+        std::printf("could not write %s\n", levelPath.c_str());
+        return 1;
+    }
+    clearObjects();
+
+    std::printf("%zu objects in %d chunks (%zu byte snapshot), %.1f ms budget per frame\n\n", objects, CHUNKS * CHUNKS, snapshot.size(), BUDGET * 1000);
+
+    // the whole world in a single frame
+    std::vector<double> frames;
+    for (int i = 0; i < 5; i++)
+    {
+        std::istringstream input(snapshot);
+        frames.emplace_back(frame([&](){ Bench::keep(SceneSnapshot::load(input).size()); }));
+        clearObjects();
+    }
+    printFrames("SceneSnapshot::load (whole world, one frame)", frames);
+
+    // the whole world spread over as many frames as the budget needs, decoding is done before the first frame
+    frames.clear();
+    {
+        SceneSnapshot::IncrementalLoad load;
+        load.decode(snapshot.data(), snapshot.size());
+        bool done = false;
+        while (!done)
+        {
+            frames.emplace_back(frame([&](){
+                done = load.instantiate(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(BUDGET)));
+            }));
+        }
+    }
+    printFrames("IncrementalLoad::instantiate (whole world)", frames);
+    clearObjects();
+
+    // a camera moving across the middle of the world, chunks are loaded ahead and destroyed behind it
+    // destroying the unloaded objects (ClearDestroyQueue) is counted as part of the frame
+    frames.clear();
+    {
+        LevelStreamer level;
+        level.open(levelPath);
+        level.setLoadDistance(CHUNK_SIZE * 4);
+        level.setUnloadDistance(CHUNK_SIZE * 6);
+        level.setTimeBudget(BUDGET);
+
+        const float middle = CHUNKS * CHUNK_SIZE / 2;
+        for (float x = 0; x <= CHUNKS * CHUNK_SIZE; x += 2.f)
+        {
+            auto next = std::chrono::steady_clock::now() + FRAME_TIME;
+            frames.emplace_back(frame([&](){
+                level.update({x, middle});
+                ObjectManager::ClearDestroyQueue();
+            }));
+            std::this_thread::sleep_until(next);
+        }
+        std::printf("%zu chunks loaded at the end (%zu objects)\n", level.getNumberOfLoadedChunks(), (std::size_t)ObjectManager::getNumberOfObjects());
+        level.close();
+    }
+    printFrames("LevelStreamer::update (moving camera)", frames);
+    clearObjects();
+
+    std::filesystem::remove(levelPath);
+    return 0;
+}
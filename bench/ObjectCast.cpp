@@ -0,0 +1,92 @@
+// compares Object::cast (cached per most derived type) with dynamic_cast on a mix of object types
+
+#include <vector>
+
+#include "Bench.hpp"
+#include "ObjectManager.hpp"
+#include "UpdateInterface.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Physics/Collider.hpp"
+
+/// @brief the common case of a drawn physics object with an update
+class Player : public virtual Object, public Renderer<sf::RectangleShape>, public Collider, public UpdateInterface
+{
+public:
+    inline void Update(float) override {}
+};
+
+/// @brief a drawn object without physics or updates so some casts fail
+class Wall : public virtual Object, public Renderer<sf::RectangleShape> {};
+
+template <typename T>
+static double timeCast(const std::vector<Object*>& objects, std::size_t& found)
+{
+    return Bench::time([&]()
+    {
+        found = 0;
+        for (Object* object: objects)
+        {
+            found += object->cast<T>() != nullptr;
+        }
+        Bench::keep(found);
+    });
+}
+
+template <typename T>
+static double timeDynamicCast(const std::vector<Object*>& objects, std::size_t& found)
+{
+    return Bench::time([&]()
+    {
+        found = 0;
+        for (Object* object: objects)
+        {
+            found += dynamic_cast<T*>(object) != nullptr;
+        }
+        Bench::keep(found);
+    });
+}
+
+template <typename T>
+static void compare(const char* name, const std::vector<Object*>& objects)
+{
+    std::size_t found = 0;
+    std::size_t dynamicFound = 0;
+    double cached = timeCast<T>(objects, found);
+    double dynamic = timeDynamicCast<T>(objects, dynamicFound);
+    Bench::print(std::string(name) + ": cast", cached, objects.size());
+    Bench::print(std::string(name) + ": dynamic_cast", dynamic, objects.size());
+    std::printf("%-48s %10.2fx (%zu of %zu succeed)\n\n", "speedup", dynamic / cached, found, objects.size());
+    if (found != dynamicFound)
+        std::printf("the casts disagree (%zu vs %zu)\n", found, dynamicFound);
+}
+
+int main()
+{
+    constexpr std::size_t OBJECTS = 30000;
+
+    // a third of each so every target type has hits and misses
+    std::vector<Object*> objects;
+    objects.reserve(OBJECTS);
+    for (std::size_t i = 0; i < OBJECTS / 3; i++)
+    {
+        objects.emplace_back(Object::create<Player>());
+        objects.emplace_back(Object::create<Wall>());
+        objects.emplace_back(Object::create<Object>());
+    }
+    // shuffled so the types are not in a predictable order
+    Bench::Random random;
+    for (std::size_t i = objects.size(); i > 1; i--)
+    {
+        std::swap(objects[i - 1], objects[random.next(i)]);
+    }
+
+    std::printf("%zu objects (Player = Renderer<sf::RectangleShape> + Collider + UpdateInterface, Wall = Renderer<sf::RectangleShape>, Object)\n\n", objects.size());
+    compare<Renderer<sf::RectangleShape>>("Renderer<sf::RectangleShape>", objects);
+    compare<Collider>("Collider", objects);
+    compare<UpdateInterface>("UpdateInterface", objects);
+    compare<DrawableObject>("DrawableObject", objects);
+    compare<Player>("Player", objects);
+
+    ObjectManager::destroyAllObjects();
+    return 0;
+}
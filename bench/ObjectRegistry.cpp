@@ -0,0 +1,143 @@
+// compares the ObjectManager slot map with the hash set of objects keyed by id that it replaced
+
+#include <unordered_set>
+#include <vector>
+
+#include "Bench.hpp"
+#include "ObjectManager.hpp"
+
+/// @brief the old registry, a hash set of objects hashed and compared by id
+struct HashById
+{
+    using is_transparent = void;
+    inline std::size_t operator()(const Object* object) const { return std::hash<std::uint64_t>{}(object->getID()); }
+    inline std::size_t operator()(std::uint64_t id) const { return std::hash<std::uint64_t>{}(id); }
+};
+
+struct EqualById
+{
+    using is_transparent = void;
+    inline bool operator()(const Object* a, const Object* b) const { return a->getID() == b->getID(); }
+    inline bool operator()(std::uint64_t id, const Object* object) const { return id == object->getID(); }
+    inline bool operator()(const Object* object, std::uint64_t id) const { return id == object->getID(); }
+};
+
+int main()
+{
+    constexpr std::size_t OBJECTS = 100000;
+    constexpr std::size_t LOOKUPS = 1000000;
+
+    std::vector<Object*> objects;
+    objects.reserve(OBJECTS);
+    for (std::size_t i = 0; i < OBJECTS; i++)
+    {
+        objects.emplace_back(new Object());
+    }
+    std::unordered_set<Object*, HashById, EqualById> set(objects.begin(), objects.end());
+
+    // random ids with a quarter of them destroyed so misses are measured too
+    Bench::Random random;
+    std::vector<std::uint64_t> ids(LOOKUPS);
+    for (std::uint64_t& id: ids)
+    {
+        id = objects[random.next(OBJECTS)]->getID();
+    }
+    for (std::size_t i = 0; i < OBJECTS; i += 4)
+    {
+        set.erase(objects[i]);
+        objects[i]->destroy();
+    }
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+
+    std::printf("%zu objects (%zu alive), %zu random lookups\n\n", OBJECTS, (std::size_t)ObjectManager::getNumberOfObjects(), LOOKUPS);
+
+    std::size_t found = 0;
+    double registry = Bench::time([&]()
+    {
+        found = 0;
+        for (std::uint64_t id: ids)
+        {
+            found += ObjectManager::getObjectRaw(id) != nullptr;
+        }
+        Bench::keep(found);
+    });
+    Bench::print("lookup: slot map", registry, LOOKUPS);
+
+    std::size_t hashFound = 0;
+    double hash = Bench::time([&]()
+    {
+        hashFound = 0;
+        for (std::uint64_t id: ids)
+        {
+            hashFound += set.find(id) != set.end();
+        }
+        Bench::keep(hashFound);
+    });
+    Bench::print("lookup: hash set", hash, LOOKUPS);
+    if (found != hashFound)
+        std::printf("the registries disagree (%zu vs %zu)\n", found, hashFound);
+
+    std::uint64_t sum = 0;
+    double iterateRegistry = Bench::time([&]()
+    {
+        sum = 0;
+        for (Object* object: ObjectManager::getObjects())
+        {
+            sum += object->getID();
+        }
+        Bench::keep(sum);
+    });
+    Bench::print("iterate: dense vector", iterateRegistry, set.size());
+
+    double iterateHash = Bench::time([&]()
+    {
+        sum = 0;
+        for (Object* object: set)
+        {
+            sum += object->getID();
+        }
+        Bench::keep(sum);
+    });
+    Bench::print("iterate: hash set", iterateHash, set.size());
+
+    // the slot map is updated by every constructor and destructor so the whole object is timed
+    // the hash set cost is what the old registry added on top of that
+    std::vector<Object*> churn(OBJECTS);
+    double createDestroy = Bench::time([&]()
+    {
+        for (Object*& object: churn)
+        {
+            object = new Object();
+        }
+        for (Object* object: churn)
+        {
+            object->destroy();
+        }
+        ObjectManager::ClearDestroyQueue();
+        ObjectManager::ClearDestroyQueue();
+    });
+    Bench::print("create + destroy (with slot map)", createDestroy, OBJECTS);
+
+    for (Object*& object: churn)
+    {
+        object = new Object();
+    }
+    double insertErase = Bench::time([&]()
+    {
+        for (Object* object: churn)
+        {
+            set.insert(object);
+        }
+        for (Object* object: churn)
+        {
+            set.erase(object);
+        }
+    });
+    Bench::print("hash set insert + erase only", insertErase, OBJECTS);
+
+    std::printf("\nlookup speedup %.2fx, iteration speedup %.2fx\n", hash / registry, iterateHash / iterateRegistry);
+
+    ObjectManager::destroyAllObjects();
+    return 0;
+}
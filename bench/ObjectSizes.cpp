@@ -0,0 +1,43 @@
+// prints the size of the object classes and how much of each is event storage
+
+#include "Bench.hpp"
+#include "Object.hpp"
+#include "UpdateInterface.hpp"
+#include "Graphics/Canvas.hpp"
+#include "Graphics/DrawableObject.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Particles/ParticleEmitter.hpp"
+#include "Physics/Collider.hpp"
+
+/// @brief the number of LazyEvent members in Object (6 public and 6 internal)
+constexpr std::size_t OBJECT_EVENTS = 12;
+
+static_assert(sizeof(LazyEvent) == sizeof(void*), "a LazyEvent should only be a pointer until something connects");
+
+/// @brief the bytes saved in every object compared to storing each event directly
+constexpr std::size_t SAVED = OBJECT_EVENTS * (sizeof(EventHelper::Event) - sizeof(LazyEvent));
+
+static void printSize(const char* name, std::size_t size)
+{
+    std::printf("%-32s %8zu %8zu\n", name, size, size + SAVED);
+}
+
+int main()
+{
+    std::printf("sizeof(EventHelper::Event)       %8zu (also the heap allocation of each connected LazyEvent)\n", sizeof(EventHelper::Event));
+    std::printf("sizeof(LazyEvent)                %8zu\n", sizeof(LazyEvent));
+    std::printf("object event storage             %8zu (was %zu)\n\n", OBJECT_EVENTS * sizeof(LazyEvent), OBJECT_EVENTS * sizeof(EventHelper::Event));
+
+    // the size with direct events is this size plus the difference for each event, every class has a single virtual Object base
+    std::printf("%-32s %8s %8s\n", "class", "sizeof", "before");
+    printSize("Object", sizeof(Object));
+    printSize("UpdateInterface", sizeof(UpdateInterface));
+    printSize("DrawableObject", sizeof(DrawableObject));
+    printSize("Collider", sizeof(Collider));
+    printSize("Renderer<sf::RectangleShape>", sizeof(Renderer<sf::RectangleShape>));
+    printSize("Renderer<sf::CircleShape>", sizeof(Renderer<sf::CircleShape>));
+    printSize("Renderer<sf::ConvexShape>", sizeof(Renderer<sf::ConvexShape>));
+    printSize("Canvas", sizeof(Canvas));
+    printSize("ParticleEmitter", sizeof(ParticleEmitter));
+    return 0;
+}
@@ -0,0 +1,103 @@
+// measures how UpdateManager::Update scales with the number of threads for thread safe objects
+// usage: ParallelUpdate [max threads] (defaults to the number of hardware threads)
+
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+#include "Bench.hpp"
+#include "ObjectManager.hpp"
+#include "ThreadPool.hpp"
+#include "UpdateInterface.hpp"
+#include "UpdateManager.hpp"
+
+/// @brief a thread safe object that only moves itself
+class Mover : public UpdateInterface
+{
+public:
+    inline Mover()
+    {
+        setThreadSafeUpdate(true);
+    }
+
+    inline void Update(float deltaTime) override
+    {
+        move(deltaTime, 0.f);
+    }
+};
+
+/// @brief a thread safe object with more work per update (like steering or animation) that only touches its own data
+class Steering : public UpdateInterface
+{
+public:
+    inline Steering()
+    {
+        setThreadSafeUpdate(true);
+    }
+
+    inline void Update(float deltaTime) override
+    {
+        for (int i = 0; i < 32; i++)
+        {
+            m_angle += std::sin(m_angle + deltaTime) * 0.01f;
+            m_speed = m_speed * 0.99f + std::cos(m_angle) * 0.01f;
+        }
+    }
+
+private:
+    float m_angle = 0.f;
+    float m_speed = 1.f;
+};
+
+static void runScaling(const char* name, std::size_t objects, unsigned maxThreads)
+{
+    std::printf("%s: %zu objects\n", name, objects);
+    UpdateManager::setParallelEnabled(false);
+    double serial = Bench::time([](){ UpdateManager::Update(1.f / 60.f); });
+    Bench::print("parallel disabled", serial, objects);
+
+    UpdateManager::setParallelEnabled(true);
+    double single = 0;
+    for (unsigned threads = 1; threads <= maxThreads; threads++)
+    {
+        ThreadPool::get().reset(threads);
+        double time = Bench::time([](){ UpdateManager::Update(1.f / 60.f); });
+        if (threads == 1)
+            single = time;
+        Bench::print(std::to_string(threads) + " thread" + (threads == 1 ? "" : "s"), time, objects);
+        std::printf("%-48s %10.2fx speedup %8.0f%% efficiency\n", "", single / time, single / time / threads * 100);
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    constexpr std::size_t OBJECTS = 100000;
+
+    const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned maxThreads = argc > 1 ? (unsigned)std::max(1, std::atoi(argv[1])) : hardwareThreads;
+    std::printf("%u hardware threads, measuring 1 to %u threads (chunk size %zu)\n\n", hardwareThreads, maxThreads, UpdateManager::getParallelChunkSize());
+
+    for (std::size_t i = 0; i < OBJECTS; i++)
+    {
+        Object::create<Mover>();
+    }
+    UpdateManager::Start();
+    runScaling("Mover (move only)", OBJECTS, maxThreads);
+    ObjectManager::destroyAllObjects();
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+
+    for (std::size_t i = 0; i < OBJECTS; i++)
+    {
+        Object::create<Steering>();
+    }
+    UpdateManager::Start();
+    runScaling("Steering (32 sin and cos per update)", OBJECTS, maxThreads);
+    ObjectManager::destroyAllObjects();
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+
+    ThreadPool::get().reset(hardwareThreads);
+    return 0;
+}
@@ -0,0 +1,135 @@
+// compares spawning enemies with hand-written constructors against instantiating a prefab one at a time and in a batch
+
+#include <vector>
+
+#include "Bench.hpp"
+#include "ObjectManager.hpp"
+#include "Prefab.hpp"
+#include "UpdateInterface.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Physics/Collider.hpp"
+
+/// @brief a drawn physics object with an update, the kind of object that is spawned in large numbers
+class Enemy : public virtual Object, public Renderer<sf::RectangleShape>, public Collider, public UpdateInterface
+{
+public:
+    inline Enemy()
+    {
+        setSize({1.f, 1.f});
+        createFixture(Fixture::Shape::Polygon(1.f, 1.f));
+    }
+
+    inline void Update(float) override {}
+};
+
+/// @brief a drawn child of each enemy so every copy is a small subtree
+class HealthBar : public virtual Object, public Renderer<sf::RectangleShape>
+{
+public:
+    inline HealthBar()
+    {
+        setSize({1.f, 0.1f});
+    }
+};
+
+static void clearObjects()
+{
+    ObjectManager::destroyAllObjects();
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+}
+
+/// @brief times the given spawn function once and destroys everything it spawned
+/// @returns the time in milliseconds
+template <typename Function>
+static double timeSpawn(const Function& spawn)
+{
+    double time = Bench::time(spawn, 1);
+    clearObjects();
+    return time;
+}
+
+static void printSpawn(const std::string& name, double milliseconds, std::size_t count)
+{
+    Bench::print(name, milliseconds, count);
+    std::printf("%-48s %10.0f enemies/s\n", "", (double)count / (milliseconds / 1000));
+}
+
+int main()
+{
+    SceneSnapshot::registerType<Enemy>("Enemy");
+    SceneSnapshot::registerType<HealthBar>("HealthBar");
+
+    Prefab prefab;
+    {
+        Enemy* enemy = new Enemy();
+        HealthBar* bar = new HealthBar();
+        bar->setParent(enemy);
+        bar->setPosition(0.f, 1.f);
+        prefab.capture(enemy);
+        clearObjects();
+    }
+    std::printf("each enemy is %zu objects (Enemy = Renderer<sf::RectangleShape> + Collider + UpdateInterface, with a Renderer child)\n\n", prefab.getNumberOfObjects());
+
+    for (std::size_t count: {1000, 10000})
+    {
+        std::vector<Transform> transforms(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            transforms[i].position = Vector2((float)(i % 100) * 2.f, (float)(i / 100) * 2.f);
+        }
+
+        auto spawnByHand = [&]()
+        {
+            for (const Transform& transform: transforms)
+            {
+                Enemy* enemy = new Enemy();
+                enemy->setPosition(transform.position);
+                HealthBar* bar = new HealthBar();
+                bar->setParent(enemy);
+                bar->setPosition(transform.position + Vector2(0.f, 1.f));
+            }
+        };
+        auto spawnSingle = [&]()
+        {
+            for (const Transform& transform: transforms)
+            {
+                Bench::keep(prefab.instantiate(transform));
+            }
+        };
+        auto spawnBatch = [&]()
+        {
+            Bench::keep(prefab.instantiate(transforms).size());
+        };
+
+        // the order is rotated each run since the free lists left by destroying one run change how fast the next run allocates
+        double byHand = 1e300;
+        double single = 1e300;
+        double batch = 1e300;
+        for (int run = 0; run < 6; run++)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                switch ((run + i) % 3)
+                {
+                case 0:
+                    byHand = std::min(byHand, timeSpawn(spawnByHand));
+                    break;
+                case 1:
+                    single = std::min(single, timeSpawn(spawnSingle));
+                    break;
+                default:
+                    batch = std::min(batch, timeSpawn(spawnBatch));
+                    break;
+                }
+            }
+        }
+
+        printSpawn(std::to_string(count) + " enemies: constructors", byHand, count);
+        printSpawn(std::to_string(count) + " enemies: prefab one at a time", single, count);
+        printSpawn(std::to_string(count) + " enemies: prefab batch", batch, count);
+        std::printf("%-48s %10.2fx\n\n", "batch speedup over constructors", byHand / batch);
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#ifndef ACTIVATION_REGIONS_HPP
+#define ACTIVATION_REGIONS_HPP
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Object.hpp"
+
+/// @brief suspends objects in areas of the world that are far from every activator (the main camera and any added objects i.e. players)
+/// @note the world is split into square cells and each added object is stored in the cell that contains its global position
+/// @note suspended objects act as if they are disabled (no updates, drawing, or physics) without changing their enabled state
+/// @note cells become active inside the activation distance but are only suspended outside the suspension distance so objects near the edge do not switch every frame
+class ActivationRegions
+{
+public:
+    /// @brief sets the size of each cell
+    /// @note every added object is put back into the cell for its position
+    static void setCellSize(float size);
+    static float getCellSize();
+    /// @brief cells closer than this to an activator (from the activator to the edge of the cell) are active
+    static void setActivationDistance(float distance);
+    static float getActivationDistance();
+    /// @brief cells further than this from every activator (from the activator to the edge of the cell) are suspended
+    /// @note this is never less than the activation distance
+    static void setSuspensionDistance(float distance);
+    static float getSuspensionDistance();
+    /// @brief if true the main camera is always an activator
+    /// @note true by default
+    static void setMainCameraActivator(bool activator = true);
+    static bool isMainCameraActivator();
+
+    /// @brief adds the object (and its children) to the cell it is currently in
+    /// @note objects with a parent should not be added, they are suspended with their parent
+    /// @note destroyed objects are removed automatically once their cell is active
+    static void addObject(Object* object);
+    /// @brief removes the object from its cell and resumes it if it was suspended
+    static void removeObject(Object* object);
+    /// @brief cells around the given object are kept active
+    /// @note destroyed activators are removed automatically
+    static void addActivator(Object* object);
+    static void removeActivator(Object* object);
+
+    /// @brief suspends and resumes cells and moves objects in active cells that changed cell
+    /// @note objects in suspended cells do not move so only objects in active cells are checked
+    /// @note this is called by the engine before the update
+    static void update();
+
+    static std::size_t getNumberOfCells();
+    static std::size_t getNumberOfActiveCells();
+    /// @returns the number of added objects
+    static std::size_t getNumberOfObjects();
+
+protected:
+
+private:
+    inline ActivationRegions() = default;
+
+    struct m_cell
+    {
+        /// @brief the ids of the objects in this cell
+        std::vector<std::uint64_t> objects;
+        bool active = true;
+    };
+
+    /// @brief where an added object is stored
+    struct m_location
+    {
+        std::uint64_t cell = 0;
+        std::size_t index = 0;
+    };
+
+    static std::uint64_t m_getCellKey(const Vector2& position);
+    /// @brief finds the position of every activator for this update
+    /// @note removes destroyed activators
+    static void m_updateActivatorPositions();
+    /// @returns the distance from the cell to the closest activator
+    static float m_getActivatorDistance(std::uint64_t cell);
+    static float m_getDistance(std::uint64_t cell, const Vector2& position);
+    /// @brief adds the object to the given cell and suspends or resumes it to match the cell
+    static void m_addToCell(Object* object, std::uint64_t cell);
+    /// @brief removes the object at the given index in the cell (does not change if it is suspended)
+    static void m_removeFromCell(m_cell& cell, std::size_t index);
+
+    static float m_cellSize;
+    static float m_activationDistance;
+    static float m_suspensionDistance;
+    static bool m_mainCameraActivator;
+    static std::unordered_map<std::uint64_t, m_cell> m_cells;
+    /// @brief the location of every added object by id
+    static std::unordered_map<std::uint64_t, m_location> m_locations;
+    static std::vector<Object::Ptr<>> m_activators;
+    static std::vector<Vector2> m_activatorPositions;
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include "SFML/Window/Event.hpp"
 #include "SFML/System/Clock.hpp"
 #include "SFML/Graphics/RenderWindow.hpp"
+#include "FrameGraph.hpp"
 #include <list>
 
 /// @brief this is not required to be used and is more as a helper for simple setup
@@ -28,22 +29,32 @@ public:
     /// @returns whether the event was handled via the command prompt or canvas manager
     bool handleEvent(const sf::Event& event, bool handled = false);
     /// @brief call before your code in the while loop
+    /// @note runs the frame graph
     void preUserCode();
     void postUserCode();
     void close();
     float getDeltaTime() const;
+    /// @brief the tasks run by preUserCode (update, debug displays, physics, collision callbacks, and late update)
+    /// @note the engine tasks are added when the engine is first used so they can be changed before init
+    /// @note tasks can be added to run with the engine tasks, use FrameGraph::insertTask to run before one of them
+    /// @note the timings of the last frame can be printed with FrameGraph::printTimings
+    FrameGraph& getFrameGraph();
     /// @param themes in order of most wanted
     /// @param directories directories to check in ("" for current)
     void tryLoadTheme(std::list<std::string> themes, std::list<std::string> directories);
 
 private:
-    inline Engine() = default;
+    /// @note adds the engine tasks to the frame graph
+    Engine();
     inline Engine(Engine const&) = delete;
     inline void operator=(Engine const&) = delete;
+
+    /// @brief adds the engine tasks to the frame graph
+    void m_initFrameGraph();
     
     sf::Clock m_deltaClock;
     float m_deltaTime = 0;
-    float m_fixedUpdate = 0;
+    FrameGraph m_frameGraph;
 };
 
 #endif
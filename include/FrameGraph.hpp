@@ -0,0 +1,127 @@
+#ifndef FRAME_GRAPH_HPP
+#define FRAME_GRAPH_HPP
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// @brief runs the tasks of a frame in the order they were added while letting tasks that do not share anything run at the same time
+/// @note each task declares the resources it reads and writes, a task waits for every earlier task that writes what it uses or reads what it writes
+/// @note main thread tasks are run by the thread calling run() in the order they were added, every other task is run on the thread pool as soon as it is ready
+/// @note the time of each task is recorded every run so the critical path (the chain of tasks that decided the frame time) can be printed
+class FrameGraph
+{
+public:
+    using Resources = std::uint64_t;
+
+    /// @brief the resources used by the engine tasks
+    enum Resource : Resources
+    {
+        None = 0,
+        /// @brief object state and anything user code can change (update functions and events)
+        Objects = 1 << 0,
+        /// @brief local and global transforms
+        Transforms = 1 << 1,
+        /// @brief the box2d world and colliders
+        Physics = 1 << 2,
+        /// @brief drawables, cameras, and the GUI
+        Graphics = 1 << 3,
+        /// @brief the VarDisplay and TFuncDisplay data and widgets
+        Debug = 1 << 4,
+        /// @brief the first bit that is not used by the engine, user resources should use User, User << 1, ...
+        User = 1 << 8,
+        /// @brief tasks that run user code should write this since user code can change anything
+        All = ~Resources(0)
+    };
+
+    /// @note a task can not be added or removed while running
+    /// @param mainThread if false the task is run on the thread pool
+    /// @warning thread pool tasks should not wait on other thread pool tasks
+    /// @returns the index of the task
+    std::size_t addTask(const std::string& name, Resources reads, Resources writes, std::function<void()> function, bool mainThread = true);
+    /// @brief adds the task right before the task with the given name so it is ordered before it
+    /// @note the task is added at the end if there is no task with the given name
+    /// @returns the index of the task
+    std::size_t insertTask(const std::string& before, const std::string& name, Resources reads, Resources writes, std::function<void()> function, bool mainThread = true);
+    /// @brief removes the first task with the given name
+    void removeTask(const std::string& name);
+    /// @brief replaces the function of the first task with the given name (i.e. to replace one of the engine tasks)
+    /// @note the resources and thread of the task stay the same
+    /// @note a task can not be changed while running
+    void setTaskFunction(const std::string& name, std::function<void()> function);
+    void clear();
+    std::size_t getNumberOfTasks() const;
+    /// @returns the index of the first task with the given name (getNumberOfTasks() if there is none)
+    std::size_t getTaskIndex(const std::string& name) const;
+
+    /// @brief runs every task and returns once they are all done
+    /// @note if a task throws the tasks that did not start yet are skipped and the first exception is rethrown once every running task is done
+    void run();
+
+    /// @returns the time the last run took in seconds
+    float getFrameTime() const;
+    /// @returns the time the given task took in the last run in seconds
+    float getTaskTime(std::size_t task) const;
+    /// @returns the indices of the tasks on the critical path of the last run from first to last
+    /// @note each task on the path is the one that finished last before the next task could start (its dependency or the main thread task before it)
+    std::vector<std::size_t> getCriticalPath() const;
+    /// @brief prints the critical path and a timeline of every task in the last run
+    /// @note tasks on the critical path are marked with a *
+    void printTimings(std::ostream& stream) const;
+    /// @brief writes the dependencies of each task in graphviz dot format with the critical path of the last run in red
+    void writeDot(std::ostream& stream) const;
+
+protected:
+
+private:
+    struct m_task
+    {
+        std::string name;
+        Resources reads = None;
+        Resources writes = None;
+        std::function<void()> function;
+        bool mainThread = true;
+        /// @brief the earlier tasks this task waits for (only the ones not already implied by another dependency)
+        std::vector<std::size_t> dependencies;
+        /// @brief the later tasks that wait for this task
+        std::vector<std::size_t> dependents;
+        /// @brief from the start of the last run in seconds
+        float start = 0;
+        float end = 0;
+        /// @brief the main thread task run before this one in the last run (or the number of tasks)
+        std::size_t previousMain = 0;
+    };
+
+    /// @brief finds the dependencies of every task
+    void m_build();
+    /// @brief runs the task on the main thread or the thread pool
+    void m_dispatch(std::size_t task);
+    void m_execute(std::size_t task);
+
+    std::vector<m_task> m_tasks;
+    bool m_built = false;
+    bool m_running = false;
+    float m_frameTime = 0;
+
+    std::unique_ptr<std::atomic<std::size_t>[]> m_remaining;
+    std::mutex m_lock;
+    std::condition_variable m_condition;
+    /// @brief main thread tasks that are ready to run
+    std::vector<std::size_t> m_ready;
+    std::size_t m_finished = 0;
+    std::atomic<bool> m_failed = false;
+    std::exception_ptr m_exception;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+#endif
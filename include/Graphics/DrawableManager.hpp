@@ -4,6 +4,7 @@
 #pragma once
 
 #include <set>
+#include <unordered_set>
 
 #include "SFML/Graphics/RenderWindow.hpp"
 #include "DrawableObject.hpp"
@@ -19,6 +20,12 @@ public:
     static void addDrawable(DrawableObject* DrawableObject);
     /// @warning dont use this unless you know what you are doing
     static void removeDrawable(DrawableObject* DrawableObject);
+    /// @brief drawables added after this are kept unsorted until endBatch is called
+    /// @note use this when adding many drawables at once (batches can be nested)
+    /// @warning nothing should be drawn while batching
+    static void beginBatch();
+    /// @brief sorts every drawable added since beginBatch and adds them to the draw order
+    static void endBatch();
 protected:
     /// @param start the starting iterator
     /// @param end one past the last iterator
@@ -29,6 +36,9 @@ private:
     inline DrawableManager() = default;
 
     static std::set<DrawableObject*, _drawableComp> m_drawables;
+    /// @brief drawables added while batching
+    static std::unordered_set<DrawableObject*> m_batched;
+    static unsigned int m_batchDepth;
 };
 
 #endif
@@ -9,6 +9,7 @@
 #include "EngineSettings.hpp"
 
 #include <set>
+#include <memory>
 
 class DrawableManager;
 class CanvasManager;
@@ -60,10 +61,15 @@ protected:
     /// @brief draws the objects recursively 
     /// @note only use this if you know what you are doing
     /// @param stateTransform is the global transform of this objects drawable parent
+    /// @note the stateTransform is not used if the TransformStore interpolated transforms are valid
     void m_draw(sf::RenderTarget* target, Transform stateTransform);
     /// @warning assumes that the given parent is not nullptr
     /// @returns the n interpolated parent transforms
     Transform m_getNInterpolatedTransforms(Object* parent, unsigned int n);
+    /// @note allocates the set of children if this is the first child
+    void m_addDrawableChild(DrawableObject* child);
+    /// @note frees the set of children if this was the last child
+    void m_removeDrawableChild(DrawableObject* child);
 
     friend DrawableManager;
     friend CanvasManager;
@@ -74,7 +80,8 @@ private:
     DrawStage m_stage = DrawStage::Default;
 
     DrawableObject* m_drawableParent = nullptr;
-    std::set<DrawableObject*, _drawableComp> m_drawableChildren;
+    /// @brief only allocated while this has drawable children since most drawables never do
+    std::unique_ptr<std::set<DrawableObject*, _drawableComp>> m_drawableChildren;
 };
 
 #endif
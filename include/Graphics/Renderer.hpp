@@ -3,11 +3,17 @@
 
 #pragma once
 
+#include <vector>
+
 #include "SFML/Graphics/Shape.hpp"
+#include "SFML/Graphics/RectangleShape.hpp"
+#include "SFML/Graphics/CircleShape.hpp"
+#include "SFML/Graphics/ConvexShape.hpp"
 
 #include "Object.hpp"
 #include "Graphics/DrawableObject.hpp"
 #include "EngineSettings.hpp"
+#include "SnapshotStream.hpp"
 // #include "Physics/WorldHandler.hpp"
 
 // TODO make renderers for other sfml drawables
@@ -67,6 +73,74 @@ public:
         return globalBounds;
     }
 
+    /// @brief writes the draw settings and shape parameters for scene snapshots (SceneSnapshot)
+    /// @note textures are not written
+    inline void writeRendererSnapshot(SnapshotWriter& writer) const
+    {
+        writer.write<std::int32_t>(DrawableObject::getLayer());
+        writer.write<std::int32_t>((std::int32_t)DrawableObject::getDrawStage());
+        writer.write<sf::Color>(T::getFillColor());
+        writer.write<sf::Color>(T::getOutlineColor());
+        writer.write<float>(T::getOutlineThickness());
+        writer.write<sf::Vector2f>(T::getOrigin());
+        writer.write<sf::Vector2f>(T::getScale());
+        if constexpr (std::is_base_of_v<sf::RectangleShape, T>)
+        {
+            writer.write<sf::Vector2f>(T::getSize());
+        }
+        else if constexpr (std::is_base_of_v<sf::CircleShape, T>)
+        {
+            writer.write<float>(T::getRadius());
+            writer.write<std::uint64_t>(T::getPointCount());
+        }
+        else if constexpr (std::is_base_of_v<sf::ConvexShape, T>)
+        {
+            writer.write<std::uint64_t>(T::getPointCount());
+            for (std::size_t i = 0; i < T::getPointCount(); i++)
+            {
+                writer.write<sf::Vector2f>(T::getPoint(i));
+            }
+        }
+    }
+
+    /// @brief reads the draw settings and shape parameters written by writeRendererSnapshot
+    inline void readRendererSnapshot(SnapshotReader& reader)
+    {
+        DrawableObject::setLayer(reader.read<std::int32_t>());
+        DrawableObject::setDrawStage((DrawStage)reader.read<std::int32_t>());
+        T::setFillColor(reader.read<sf::Color>());
+        T::setOutlineColor(reader.read<sf::Color>());
+        T::setOutlineThickness(reader.read<float>());
+        T::setOrigin(reader.read<sf::Vector2f>());
+        T::setScale(reader.read<sf::Vector2f>());
+        if constexpr (std::is_base_of_v<sf::RectangleShape, T>)
+        {
+            T::setSize(reader.read<sf::Vector2f>());
+        }
+        else if constexpr (std::is_base_of_v<sf::CircleShape, T>)
+        {
+            T::setRadius(reader.read<float>());
+            T::setPointCount((std::size_t)reader.read<std::uint64_t>());
+        }
+        else if constexpr (std::is_base_of_v<sf::ConvexShape, T>)
+        {
+            std::uint64_t count = reader.read<std::uint64_t>();
+            // read before setting the count so a corrupt count can not allocate more points than the data holds
+            std::vector<sf::Vector2f> points;
+            for (std::uint64_t i = 0; i < count && reader.isValid(); i++)
+            {
+                points.emplace_back(reader.read<sf::Vector2f>());
+            }
+            if (!reader.isValid())
+                return;
+            T::setPointCount(points.size());
+            for (std::size_t i = 0; i < points.size(); i++)
+            {
+                T::setPoint(i, points[i]);
+            }
+        }
+    }
+
 protected:
     inline void Draw(sf::RenderTarget* target, const Transform& thisTransform) override
     {
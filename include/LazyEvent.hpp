@@ -0,0 +1,104 @@
+#ifndef LAZY_EVENT_HPP
+#define LAZY_EVENT_HPP
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "Utils/EventHelper.hpp"
+
+/// @brief an event that is only allocated once something connects to it
+/// @note objects have many events that are almost always empty, this keeps each of them to a single pointer
+/// @note invoking an event that was never allocated does nothing
+class LazyEvent
+{
+public:
+    inline LazyEvent() = default;
+    LazyEvent(const LazyEvent&) = delete;
+    void operator=(const LazyEvent&) = delete;
+
+    /// @note same as EventHelper::Event::connect
+    template <typename... Args>
+    inline auto connect(Args&&... args)
+    {
+        return get().connect(std::forward<Args>(args)...);
+    }
+
+    /// @note same as EventHelper::Event::operator()
+    template <typename... Args>
+    inline auto operator()(Args&&... args)
+    {
+        return get()(std::forward<Args>(args)...);
+    }
+
+    /// @note does nothing if nothing was ever connected
+    template <typename... Args>
+    inline auto invoke(Args&&... args) -> decltype(std::declval<EventHelper::Event&>().invoke(std::forward<Args>(args)...))
+    {
+        using Result = decltype(std::declval<EventHelper::Event&>().invoke(std::forward<Args>(args)...));
+        if (m_event == nullptr)
+        {
+            if constexpr (std::is_void_v<Result>)
+                return;
+            else
+                return Result{};
+        }
+        return m_event->invoke(std::forward<Args>(args)...);
+    }
+
+    /// @returns false if nothing was ever connected
+    template <typename... Args>
+    inline bool disconnect(Args&&... args)
+    {
+        if (m_event == nullptr)
+            return false;
+        return m_event->disconnect(std::forward<Args>(args)...);
+    }
+
+    inline void disconnectAll()
+    {
+        if (m_event != nullptr)
+            m_event->disconnectAll();
+    }
+
+    /// @note disabling an event that was never allocated allocates it so the state is kept
+    inline void setEnabled(bool enabled = true)
+    {
+        if (m_event == nullptr && enabled)
+            return;
+        get().setEnabled(enabled);
+    }
+
+    inline bool isEnabled() const
+    {
+        return m_event == nullptr || m_event->isEnabled();
+    }
+
+    /// @returns true if the event has been allocated
+    inline bool isAllocated() const
+    {
+        return m_event != nullptr;
+    }
+
+    /// @note allocates the event if it does not exist yet
+    /// @returns the underlying event
+    inline EventHelper::Event& get()
+    {
+        if (m_event == nullptr)
+            m_event = std::make_unique<EventHelper::Event>();
+        return *m_event;
+    }
+
+    /// @note allocates the event if it does not exist yet
+    inline operator EventHelper::Event&()
+    {
+        return get();
+    }
+
+private:
+    std::unique_ptr<EventHelper::Event> m_event;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef LEVEL_STREAMER_HPP
+#define LEVEL_STREAMER_HPP
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Object.hpp"
+#include "MappedFile.hpp"
+#include "SceneSnapshot.hpp"
+
+/// @brief streams a large level in square chunks around the main camera
+/// @note a level file is a table of chunks followed by a scene snapshot for each chunk (see SceneSnapshot for what is stored)
+/// @note chunks in the load distance are decoded from the memory mapped file on the thread pool and their objects are then created on the main thread within the time budget
+/// @note chunks outside the unload distance are saved and their objects are destroyed, chunks that changed since they were loaded are saved to a temporary file
+/// (the others are loaded from the level file again) so unloaded chunks are not kept in memory
+/// @note only objects with a registered snapshot type are kept when a chunk is unloaded
+/// @note objects stay in the chunk they were loaded from even if they move into another chunk
+class LevelStreamer
+{
+public:
+    /// @brief levels with a different version can not be opened
+    static constexpr std::uint32_t VERSION = 1;
+
+    inline LevelStreamer() = default;
+    /// @note closes the level (destroying every loaded object)
+    ~LevelStreamer();
+    LevelStreamer(const LevelStreamer&) = delete;
+    void operator=(const LevelStreamer&) = delete;
+
+    /// @brief writes a level where each of the given objects (and its children) is put in the chunk that contains its global position
+    /// @returns false if the file could not be written
+    static bool writeLevel(const std::string& filePath, float chunkSize, const std::vector<Object*>& roots);
+
+    /// @brief maps the level file, nothing is loaded until update is called
+    /// @note closes any level that is currently open
+    /// @returns false if the file is not a valid level
+    bool open(const std::string& filePath);
+    /// @brief destroys every object that was loaded by this level
+    /// @note waits for any chunks that are still being decoded
+    void close();
+    bool isOpen() const;
+    /// @brief saves every chunk to the given file (loaded chunks are saved as they are now)
+    /// @warning can not be the file that is currently open
+    /// @returns false if the file could not be written
+    bool save(const std::string& filePath);
+
+    /// @brief loads and unloads chunks around the main camera
+    /// @note should be called once per frame
+    void update();
+    /// @brief loads and unloads chunks around the given position
+    /// @note should be called once per frame
+    void update(const Vector2& center);
+
+    /// @brief chunks closer than this (from the center to the edge of the chunk) are loaded
+    void setLoadDistance(float distance);
+    float getLoadDistance() const;
+    /// @brief chunks further than this (from the center to the edge of the chunk) are unloaded
+    /// @note this is never less than the load distance so chunks on the edge do not load and unload every frame
+    void setUnloadDistance(float distance);
+    float getUnloadDistance() const;
+    /// @brief the maximum time spent creating objects each update
+    /// @note at least one object is created each update if any chunk is waiting
+    void setTimeBudget(float seconds);
+    float getTimeBudget() const;
+
+    float getChunkSize() const;
+    std::size_t getNumberOfChunks() const;
+    /// @returns the number of chunks that have all their objects created
+    std::size_t getNumberOfLoadedChunks() const;
+    /// @returns true if no chunks are being decoded or created
+    bool isIdle() const;
+    /// @returns the size of the temporary file that changed chunks are saved to when they are unloaded
+    std::uint64_t getBackingFileSize() const;
+
+protected:
+
+private:
+    enum class m_chunkState
+    {
+        Unloaded,
+        /// @brief being decoded on the thread pool
+        Decoding,
+        /// @brief objects are being created on the main thread
+        Instantiating,
+        Loaded
+    };
+
+    struct m_chunk
+    {
+        std::int32_t x = 0;
+        std::int32_t y = 0;
+        /// @brief where the chunk is in the mapped file
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+        /// @brief where the chunk was written in the backing file when it was last unloaded with changes
+        std::uint64_t savedOffset = 0;
+        std::uint64_t savedSize = 0;
+        /// @brief the space for this chunk in the backing file (smaller saves are written over the last one)
+        std::uint64_t savedCapacity = 0;
+        /// @brief true if the chunk is loaded from the backing file instead of the level file
+        bool isSaved = false;
+        /// @brief true if the chunk could not be decoded so it is never loaded
+        bool invalid = false;
+        m_chunkState state = m_chunkState::Unloaded;
+        std::future<bool> decoded;
+        std::unique_ptr<SceneSnapshot::IncrementalLoad> load;
+        std::vector<Object::Ptr<>> roots;
+        /// @brief the distance from the center in the last update
+        float distance = 0;
+    };
+
+    /// @brief a chunk that is written to a level file
+    struct m_chunkData
+    {
+        std::int32_t x = 0;
+        std::int32_t y = 0;
+        const char* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    static bool m_writeLevel(const std::string& filePath, float chunkSize, const std::vector<m_chunkData>& chunks);
+    static std::uint64_t m_getKey(std::int32_t x, std::int32_t y);
+    /// @brief saves the given objects (skipping ones that were destroyed or given a parent)
+    static std::string m_saveObjects(const std::vector<Object::Ptr<>>& roots);
+
+    /// @returns the data of the chunk in the level file
+    std::pair<const char*, std::size_t> m_getData(const m_chunk& chunk) const;
+    /// @brief writes the saved chunk to the backing file (creating the file if needed)
+    /// @returns false if it could not be written
+    bool m_writeSaved(m_chunk& chunk, const std::string& data);
+    /// @brief reads a saved chunk from the backing file
+    /// @note opens its own stream so this can be called from any thread
+    /// @returns false if it could not be read
+    static bool m_readSaved(const std::string& path, std::uint64_t offset, std::uint64_t size, std::string& data);
+    float m_getDistance(const m_chunk& chunk, const Vector2& center) const;
+    void m_startLoading(std::size_t chunk);
+    /// @brief saves and destroys the objects of the chunk or stops it from loading
+    void m_unload(std::size_t chunk);
+
+    MappedFile m_file;
+    /// @brief the temporary file that changed chunks are saved to when they are unloaded
+    /// @note created the first time a changed chunk is unloaded and removed when the level is closed
+    std::fstream m_backing;
+    std::string m_backingPath;
+    std::uint64_t m_backingSize = 0;
+    float m_chunkSize = 0;
+    std::vector<m_chunk> m_chunks;
+    /// @brief chunk coordinates to the index of the chunk
+    std::unordered_map<std::uint64_t, std::size_t> m_chunkIndex;
+    /// @brief every chunk that is not unloaded
+    std::vector<std::size_t> m_active;
+    float m_loadDistance = 64;
+    float m_unloadDistance = 96;
+    float m_timeBudget = 0.002f;
+};
+
+#endif
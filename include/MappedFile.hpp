@@ -0,0 +1,45 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/// @brief a read only memory mapped file
+/// @note pages are only loaded by the os when they are first accessed
+class MappedFile
+{
+public:
+    inline MappedFile() = default;
+    /// @note check isOpen() to see if the file was mapped
+    MappedFile(const std::string& filePath);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    void operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& file) noexcept;
+    MappedFile& operator=(MappedFile&& file) noexcept;
+
+    /// @brief maps the given file (closes any file that is currently open)
+    /// @returns false if the file could not be mapped
+    bool open(const std::string& filePath);
+    /// @warning any pointers to the data are invalid after this
+    void close();
+    bool isOpen() const;
+
+    /// @returns nullptr if no file is open
+    const char* getData() const;
+    std::size_t getSize() const;
+
+protected:
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+#endif
@@ -4,22 +4,34 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 #include <list>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include "Utils/EventHelper.hpp"
+#include "LazyEvent.hpp"
 #include "EngineSettings.hpp"
 #include "Rotation.hpp"
 #include "Vector2.hpp"
 #include "Transform.hpp"
+#include "ObjectPool.hpp"
+#include "ObjectTypeInfo.hpp"
+#include "TransformStore.hpp"
 
 class ObjectManager;
-class _objectCompare;
+class SceneSnapshot;
+class ActivationRegions;
+class UpdateManager;
 
 /// @note never use smart ptrs for any object classes instead use Object::Ptr<T> for a pointer to an object which keeps track of its life time
-/// @note never create objects on the stack only create them using "new" (on the heap)
+/// @note never create objects on the stack only create them using "new" (on the heap) or Object::create<T>() (pooled)
 class Object
 {
 public:
+    /// @brief a generational handle to an object
+    /// @note validity is checked against the slot map in ObjectManager so holding a Ptr costs nothing when the object is destroyed
     /// @note this will compare to other objects/Ptrs until the stored object is completely destroyed
     /// @warning the type must have the base class Object
     template <typename T = Object>
@@ -31,42 +43,30 @@ public:
             this->set(obj);
         }
 
-        inline Ptr(Ptr& ptr) 
-        {
-            this->set(ptr.get());
-        }
-
-        inline ~Ptr()
-        {
-            set(nullptr);
-        }
+        inline Ptr(const Ptr& ptr) = default;
         
         inline T* operator->()
         {
-            return m_ptr;
+            return this->get();
         }
         
         inline const T* operator->() const
         {
-            return m_ptr;
+            return this->get();
         }
         
         inline T* operator*()
         {
-            return m_ptr;
+            return this->get();
         }
         
         inline const T* operator*() const
         {
-            return m_ptr;
+            return this->get();
         }
         
         /// @note same thing as using Object::Ptr<T>::set()
-        inline Object::Ptr<T>& operator=(const Object::Ptr<T>& Ptr)
-        {
-            this->set(Ptr.m_ptr);
-            return *this;
-        }
+        inline Object::Ptr<T>& operator=(const Object::Ptr<T>& Ptr) = default;
 
         /// @note same thing as using Object::Ptr<T>::set()
         inline Object::Ptr<T>& operator=(T* rawPtr)
@@ -125,21 +125,21 @@ public:
         /// @note the ptr returned could not be nullptr but still be invalid as it was added to the destroy queue
         inline T* get()
         {
-            return m_ptr;
+            return m_isAlive() ? m_ptr : nullptr;
         }
         
         /// @brief if there is no ptr returns nullptr
         /// @note the ptr returned could not be nullptr but still be invalid as it was added to the destroy queue
         inline const T* get() const
         {
-            return m_ptr;
+            return m_isAlive() ? m_ptr : nullptr;
         }
 
         /// @note if the ptr is invalid returns nullptr even if the object is not destroyed yet
         /// @returns the ptr to the base object
         inline Object* getObj() const
         {
-            if (isValid())
+            if (!isValid())
                 return nullptr;
             return static_cast<Object*>(m_ptr);
         }
@@ -147,57 +147,74 @@ public:
         /// @returns false if the object originally stored object was added to destroy queue
         inline bool isValid() const
         {
-            return (m_ptr != nullptr) && !m_ptr->m_destroyQueued;
+            return m_isAlive() && !m_ptr->m_destroyQueued;
         }
         
         /// @brief assigns which obj is stored in this ptr
         /// @param rawPtr the new ptr
-        inline void set(T* rawPtr)
-        {
-            if (m_ptr == rawPtr)
-                return; // no point in re connecting this ptr to the same object
-
-            if (this->m_ptr != nullptr)
-            {
-                m_ptr->m_onDestroy.disconnect(m_eventID);
-            }
-            this->removePtr();
-
-            if (rawPtr != nullptr)
-            {
-                m_ptr = rawPtr;    
-                m_eventID = m_ptr->m_onDestroy.connect(&Object::Ptr<T>::removePtr, this);
-            }
-        }
+        void set(T* rawPtr);
 
         /// @note this will return 0 when the stored object is destroyed
         /// @returns the id of the base Object class
         inline uint64_t getID() const
         {
-            return (this->m_ptr == nullptr ? 0 : this->m_ptr->getID());
-        }
-
-    protected:
-        inline void removePtr()
-        {
-            m_ptr = nullptr;
-            m_eventID = 0;
+            return (m_isAlive() ? m_id : 0);
         }
 
     private:
-        inline Ptr(const Ptr& ptr) = default;
+        /// @returns true if the stored object has not been destroyed (it may still be in the destroy queue)
+        bool m_isAlive() const;
 
         T* m_ptr = nullptr;
-        uint64_t m_eventID = 0;
+        /// @brief the id of the stored object (slot and generation in the ObjectManager slot map)
+        std::uint64_t m_id = 0;
     };
 
     Object();
     virtual ~Object();
 
+    /// @brief objects created with new use the global allocation functions
+    /// @note memory of objects released by ObjectManager::ClearDestroyQueue is freed after the batch (on the thread pool for large batches)
+    /// @note types that declare their own operator new and delete still always use them
+    static void* operator new(std::size_t size);
+    static void* operator new(std::size_t size, std::align_val_t alignment);
+    /// @brief placement new (used by Object::create)
+    static inline void* operator new(std::size_t, void* memory) noexcept
+    {
+        return memory;
+    }
+    static void operator delete(void* memory) noexcept;
+    static void operator delete(void* memory, std::align_val_t alignment) noexcept;
+
+    /// @brief creates an object of the given type in the pool for that type
+    /// @note objects of the same type are stored next to each other in memory
+    /// @note the object is destroyed the same way as any other object (destroy())
+    /// @tparam T the type of object to create (must derive from Object)
+    /// @param args the arguments given to the constructor of T
+    /// @returns the created object
+    template <typename T, typename... Args>
+    static inline T* create(Args&&... args)
+    {
+        static_assert(std::is_base_of_v<Object, T>, "Only types that derive from Object can be created");
+        ObjectPool<T>& pool = ObjectPool<T>::get();
+        T* object = new (pool.allocate()) T(std::forward<Args>(args)...);
+        static_cast<Object*>(object)->m_pool = &pool;
+        static_cast<Object*>(object)->m_typeInfo.store(&ObjectTypeInfo::get<T>(), std::memory_order_relaxed);
+        return object;
+    }
+
+    /// @note if this changes the state of any children their internal enabled/disabled events are called as well
     void setEnabled(bool enabled = true); 
+    /// @note this is cached so it is only a single load
+    /// @returns false if this object or any parent is disabled or suspended
     bool isEnabled() const;
+    /// @note suspended objects act as if they are disabled without changing their enabled state (see ActivationRegions)
+    /// @returns true if this object is suspended (does not check parents)
+    bool isSuspended() const;
 
-    unsigned long int getID() const;
+    /// @note the id is made from the objects slot and the slot generation so it is never reused while any Ptr could still refer to it
+    /// @returns the id of this object (0 if not handled by the object manager)
+    uint64_t getID() const;
     /// @note if you want a pointer to a derived type just use the Object::Ptr<T> constructor
     /// @returns the object ptr
     Object::Ptr<> getPtr();
@@ -233,35 +250,85 @@ public:
         return nullptr;
     }
 
+private:
+    //* Hot data
+    // declared right after the vtable pointer and before the events so the fields read every frame are next to each other (56 bytes with the vtable pointer)
+    // only the order changed, the per frame passes still go through each object (its virtual functions) so these are not moved into dense arrays
+
+    /// @brief true if this object and all parents are enabled
+    bool m_enabledInHierarchy = true;
+    bool m_destroyQueued = false;
+    mutable bool m_globalTransformDirty = true;
+    /// @brief the index of the local transform of this object in the TransformStore
+    std::uint32_t m_transformIndex = 0;
+    /// @brief the cached global transform, only valid if m_globalTransformDirty is false
+    mutable Transform m_globalTransform;
+    /// @brief the cached casts for the most derived type of this object
+    /// @note set by Object::create once the object is constructed, objects created with new find it on the first cast after the frame they were created in
+    mutable std::atomic<ObjectTypeInfo*> m_typeInfo = nullptr;
+    Object* m_parent = nullptr;
+    uint64_t m_id = 0;
+
+public:
     /// @note if derived class, use the virtual function
-    EventHelper::Event onEnabled;
+    LazyEvent onEnabled;
     /// @note if derived class, use the virtual function
-    EventHelper::Event onDisabled;
+    LazyEvent onDisabled;
     /// @brief this is called when the destruction of this object is queued
-    EventHelper::Event onDestroyQueued;
+    LazyEvent onDestroyQueued;
     /// @brief this is called right before the destruction of this object
     /// @note the object will be destroyed after this is called
-    EventHelper::Event onDestroy;
+    LazyEvent onDestroy;
     /// @note this is called when the parent is set to something other than the current parent
-    EventHelper::Event onParentSet;
+    LazyEvent onParentSet;
     /// @brief called when ever the transform of this object is updated
     /// @note only called if the local position is updated
-    EventHelper::Event onTransformUpdated;
+    /// @note if transform updates are deferred this is called once per flush (ObjectManager::setDeferTransformUpdates)
+    LazyEvent onTransformUpdated;
 
     /// @brief tries to cast this object to a given type
+    /// @note after the first cast to a type the result is cached for every object of the same type
     /// @returns nullptr if cast was unsuccessful  
     template<typename type>
     type* cast()
     {
-        return dynamic_cast<type*>(this);
+        return const_cast<type*>(static_cast<const Object*>(this)->cast<type>());
     }
 
     /// @brief tries to cast this object to a given type
+    /// @note after the first cast to a type the result is cached for every object of the same type
     /// @returns nullptr if cast was unsuccessful  
     template<typename type>
     const type* cast() const
     {
-        return dynamic_cast<const type*>(this);
+        if constexpr (std::is_same_v<std::remove_cv_t<type>, Object>)
+            return this;
+
+        std::size_t typeID = ObjectTypeInfo::getTypeID<std::remove_cv_t<type>>();
+        ObjectTypeInfo* typeInfo = m_typeInfo.load(std::memory_order_relaxed);
+        if (typeInfo == nullptr)
+            typeInfo = m_resolveTypeInfo();
+        // type is not known yet (could still be constructing)
+        if (typeInfo == nullptr || typeID >= ObjectTypeInfo::MAX_TYPES)
+            return dynamic_cast<const type*>(this);
+
+        std::ptrdiff_t offset = typeInfo->getOffset(typeID);
+        if (offset == ObjectTypeInfo::UNKNOWN)
+        {
+            const type* rtn = dynamic_cast<const type*>(this);
+            typeInfo->setOffset(typeID, rtn == nullptr ? ObjectTypeInfo::NOT_A : reinterpret_cast<const char*>(rtn) - reinterpret_cast<const char*>(this));
+            return rtn;
+        }
+        if (offset == ObjectTypeInfo::NOT_A)
+            return nullptr;
+        return reinterpret_cast<const type*>(reinterpret_cast<const char*>(this) + offset);
+    }
+
+    /// @returns true if this object can be cast to the given type
+    template<typename type>
+    inline bool isA() const
+    {
+        return cast<type>() != nullptr;
     }
 
     /// @brief add this object to the destroy queue
@@ -295,6 +362,7 @@ public:
     /// @returns the local position (if no parent then it is the same as global position)
     Vector2 getPosition() const;
     /// @note if no parent this is the same as position
+    /// @note cached until this object or a parent is moved
     /// @returns global position
     Vector2 getGlobalPosition() const;
     /// @brief sets the local rotation
@@ -303,18 +371,26 @@ public:
     /// @returns the local rotation (if no parent then it is the same as global rotation)
     Rotation getRotation() const;
     /// @note if no parent this is the same as rotation
+    /// @note cached until this object or a parent is rotated
     /// @returns the global rotation i.e. all parent rotations applied together
     Rotation getGlobalRotation() const;
     /// @brief sets the local transform
     void setTransform(const Transform& transform);
-    const Transform& getTransform() const;
+    /// @note the transform is stored in the TransformStore so this is a copy
+    const Transform getTransform() const;
     void setGlobalTransform(const Transform& transform);
+    /// @note cached until the transform of this object or a parent is changed
+    /// @note uses the transform computed by TransformStore::updateGlobalTransforms if nothing has changed since
     const Transform getGlobalTransform() const;
+    /// @returns the index of the transform of this object in the TransformStore
+    /// @note changes when other objects are destroyed
+    std::uint32_t getTransformIndex() const;
     void move(const Vector2& move);
     void move(float x, float y);
     void rotate(Rotation rot);
 
     /// @brief sets the stored user type for easy comparison later on
+    /// @note objects are grouped by user type in ObjectManager so all objects of a type can be found quickly
     void setUserType(uint64_t type);
     /// @returns the stored user type
     uint64_t getUserType() const;
@@ -329,62 +405,166 @@ protected:
     inline virtual void OnEnable() {};
     inline virtual void OnDisable() {};
     /// @warning do NOT disconnect all EVER
-    EventHelper::Event m_onEnabled;
+    LazyEvent m_onEnabled;
     /// @warning do NOT disconnect all EVER
-    EventHelper::Event m_onDisabled;
+    LazyEvent m_onDisabled;
     /// @brief this is called when the destruction of this object is queued
     /// @note the object should appear as if it is destroyed
-    EventHelper::Event m_onDestroyQueued;
+    LazyEvent m_onDestroyQueued;
     /// @brief this is called right before the destruction of this object
     /// @note the object will be destroyed after this is called
-    EventHelper::Event m_onDestroy;
+    LazyEvent m_onDestroy;
     /// @warning do NOT disconnect all EVER
-    EventHelper::Event m_onParentSet;
+    LazyEvent m_onParentSet;
     /// @brief called when ever the transform of this object is updated
+    /// @note if transform updates are deferred this is called once per flush (ObjectManager::setDeferTransformUpdates)
     /// @warning do NOT disconnect all EVER
-    EventHelper::Event m_onTransformUpdated;
+    LazyEvent m_onTransformUpdated;
 
+    /// @note the created object is not handled by the object manager
     /// @warning only use this if you know what you are doing
     Object(uint64_t id);
-    /// @warning only use this if you know what you are doing
-    void m_setID(uint64_t id);
 private:
+    /// @brief intrusive list of children linked through the sibling pointers of each child
+    /// @note adding and removing a child is O(1) and never allocates
+    struct m_childList
+    {
+        class iterator
+        {
+        public:
+            inline iterator(Object* object) : m_object(object) {}
+            inline Object* operator*() const { return m_object; }
+            inline iterator& operator++();
+            inline iterator operator++(int) { iterator temp = *this; ++(*this); return temp; }
+            inline bool operator==(const iterator& other) const { return m_object == other.m_object; }
+            inline bool operator!=(const iterator& other) const { return m_object != other.m_object; }
+        private:
+            Object* m_object;
+        };
+
+        inline iterator begin() const { return iterator(first); }
+        inline iterator end() const { return iterator(nullptr); }
+        inline bool empty() const { return first == nullptr; }
+        inline std::size_t size() const { return count; }
+        /// @warning the object must not already be in a child list
+        inline void push_back(Object* object);
+        /// @warning the object must be in this list
+        inline void remove(Object* object);
+        /// @brief forgets all children without touching them
+        inline void clear() { first = nullptr; last = nullptr; count = 0; }
+
+        Object* first = nullptr;
+        Object* last = nullptr;
+        std::size_t count = 0;
+    };
+
     /// @brief invokes the destroy events, sets enabled false, and calls on all children
     void m_invokeDestroyEvents();
 
     void m_addChild(Object* object);
     void m_removeChild(Object* object);
 
+    /// @brief updates the cached enabled state of all children, stops at children that did not change
+    /// @note calls the internal enabled/disabled events of every child that changed
+    void m_propagateEnabled();
+    /// @returns what the cached enabled state should be given the current parent
+    bool m_calculateEnabledInHierarchy() const;
+    /// @brief suspends or resumes this object
+    /// @note only the internal enabled/disabled events are called since the enabled state does not change
+    void m_setSuspended(bool suspended);
+
+    /// @brief calls the transform updated events or queues them if transform updates are deferred
+    void m_transformUpdated();
+
+    /// @brief marks the cached global transform of this object and all children as out of date
+    /// @note if this object is already dirty then so are all children
+    void m_setGlobalTransformDirty();
+    /// @brief recalculates the cached global transform if it is out of date
+    /// @note also updates any parents that are out of date unless the TransformStore global transforms are valid
+    void m_updateGlobalTransform() const;
+
+    /// @brief the state an object is given in its constructor before any derived constructor runs
+    struct m_initialState
+    {
+        Object* parent = nullptr;
+        Transform transform;
+        uint64_t userType = 0;
+    };
+    /// @brief sets the parent, transform, and user type without calling any events
+    /// @warning only call this from the constructor
+    void m_applyInitialState(const m_initialState& state);
+    /// @brief finds the cached casts for the most derived type of an object created with new
+    /// @returns nullptr if the object was created (or released) this frame since it could still be constructing (or destructing)
+    ObjectTypeInfo* m_resolveTypeInfo() const;
+    /// @brief the state given to the next object that is constructed (nullptr if none)
+    /// @note used by SceneSnapshot so loaded objects are created in place instead of being moved after
+    static const m_initialState* m_nextInitialState;
+
+    //* Cold data
+
     bool m_enabled = true;
-    bool m_destroyQueued = false;
-    uint64_t m_id = 0;
+    /// @brief true if this object is suspended by ActivationRegions
+    bool m_suspended = false;
+    /// @brief true if this object is in the current destroy batch
+    bool m_destroyBatched = false;
+    /// @brief true if this object is in the transform update queue
+    bool m_transformUpdateQueued = false;
+    /// @brief the frame this object was created in (see ObjectManager::ClearDestroyQueue)
+    /// @note also set when the object is released so the type is not resolved while destructing
+    std::uint32_t m_createdFrame = 0;
     uint64_t m_userType = 0;
-
-    Transform m_transform;
-
-    Object* m_parent = nullptr;
-    std::list<Object*> m_children;
-
-    static uint64_t m_lastID;
+    /// @brief the index of this object in the bucket for its user type (unused if the user type is 0)
+    std::uint32_t m_userTypeIndex = 0;
+    /// @brief the index of this object in the dense object array
+    std::uint32_t m_index = 0;
+    /// @brief the pool this object was allocated from (nullptr if created with new)
+    ObjectPoolBase* m_pool = nullptr;
+
+    m_childList m_children;
+    /// @brief the previous child of the parent
+    Object* m_prevSibling = nullptr;
+    /// @brief the next child of the parent
+    Object* m_nextSibling = nullptr;
 
     friend ObjectManager;
-    friend _objectCompare;
+    friend TransformStore;
+    friend SceneSnapshot;
+    friend ActivationRegions;
+    friend UpdateManager;
 };
 
-/// @brief this should only be used to compare objects based on ID when stored with raw ptrs
-/// @note this object is not handled by object manager
-/// @note you must set the ID to the wanted ID before trying to compare
-class _objectCompare : public Object
+inline Object::m_childList::iterator& Object::m_childList::iterator::operator++()
 {
-public:
-    inline _objectCompare() : Object(0) {}
-    /// @brief sets the object ID to the wanted ID
-    /// @note remember to set this back to 0 once done
-    inline void setID(uint64_t id)
-    {
-        Object::m_id = id;
-    }
-};
+    m_object = m_object->m_nextSibling;
+    return *this;
+}
+
+inline void Object::m_childList::push_back(Object* object)
+{
+    object->m_prevSibling = last;
+    object->m_nextSibling = nullptr;
+    if (last != nullptr)
+        last->m_nextSibling = object;
+    else
+        first = object;
+    last = object;
+    count++;
+}
+
+inline void Object::m_childList::remove(Object* object)
+{
+    if (object->m_prevSibling != nullptr)
+        object->m_prevSibling->m_nextSibling = object->m_nextSibling;
+    else
+        first = object->m_nextSibling;
+    if (object->m_nextSibling != nullptr)
+        object->m_nextSibling->m_prevSibling = object->m_prevSibling;
+    else
+        last = object->m_prevSibling;
+    object->m_prevSibling = nullptr;
+    object->m_nextSibling = nullptr;
+    count--;
+}
 
 namespace std {
     template <>
@@ -419,4 +599,7 @@ namespace std {
     };
 }
 
+// the object manager owns the slot map that Object::Ptr is validated against
+#include "ObjectManager.hpp"
+
 #endif
@@ -3,7 +3,11 @@
 
 #pragma once
 
-#include <unordered_set>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
 
 #include "Object.hpp"
 
@@ -12,35 +16,209 @@ class ObjectManager
 public:
     /// @returns nullptr if the object does not exist 
     static Object::Ptr<> getObject(uint64_t id);
+    /// @note this is a direct index into the slot map
+    /// @returns nullptr if the object does not exist
+    static inline Object* getObjectRaw(uint64_t id)
+    {
+        const m_objectSlot& slot = m_slots[(std::uint32_t)id < m_slots.size() ? (std::uint32_t)id : 0];
+        return slot.generation == (std::uint32_t)(id >> 32) ? slot.object : nullptr;
+    }
 
     static uint64_t getNumberOfObjects();
+    /// @brief makes sure that the given number of objects can be added without reallocating
+    static void reserve(std::size_t count);
+    /// @note objects are stored contiguously so iterating this is cache friendly
+    /// @warning the order changes when objects are removed
+    /// @returns every object that currently exists (including objects in the destroy queue)
+    static const std::vector<Object*>& getObjects();
+    /// @note objects of each user type are stored contiguously so this only touches objects of that type
+    /// @note user type 0 is the default and is not tracked (this is always empty for 0)
+    /// @warning the order changes when objects are removed or change user type
+    /// @returns every object with the given user type (including objects in the destroy queue)
+    static const std::vector<Object*>& getObjectsOfUserType(uint64_t type);
+    /// @note user type 0 is not tracked so this is always 0 for it
+    /// @returns the number of objects with the given user type (including objects in the destroy queue)
+    static std::size_t getNumberOfObjectsOfUserType(uint64_t type);
+    /// @brief calls the given function for every object with the given user type that is not in the destroy queue
+    /// @note user type 0 is not tracked so nothing is called for it
+    /// @warning the function should not change the user type of any object
+    /// @param func called as func(Object*)
+    template <typename Func>
+    static inline void forEachOfUserType(uint64_t type, Func&& func)
+    {
+        auto bucket = m_userTypes.find(type);
+        if (bucket == m_userTypes.end())
+            return;
+        const std::vector<Object*>& objects = bucket->second;
+        // by index since the function could create more objects of this type
+        for (std::size_t i = 0; i < objects.size(); i++)
+        {
+            if (!objects[i]->isDestroyQueued())
+                func(objects[i]);
+        }
+    }
 
     /// @brief destroys all the objects in the queue
+    /// @note whole subtrees are collected and then released children first
+    /// @note every event and destructor is called on this thread, only the heap memory of large batches is freed on the thread pool
     /// @note only use this if you know what you are doing
     static void ClearDestroyQueue();
 
-    /// @note resets all object IDs
+    /// @note IDs are not reset since they are tied to the slot generations
     static void destroyAllObjects();
 
+    /// @brief queues an object of the given type to be created on the main thread
+    /// @note this is thread safe and lock free so it can be used from jobs on the ThreadPool
+    /// @note the object is created with Object::create when the deferred commands are applied (the engine does this after user code)
+    /// @param setup called on the main thread right after the object is created (can be empty)
+    /// @param args copied and given to the constructor of T
+    /// @returns the id the object will have once it is created (getObject returns nullptr until then)
+    template <typename T, typename... Args>
+    static inline uint64_t createDeferred(std::function<void(T*)> setup = {}, Args... args)
+    {
+        static_assert(std::is_base_of_v<Object, T>, "Only types that derive from Object can be created");
+        m_deferredCommand* command = new m_deferredCommand();
+        command->id = m_reserveID();
+        command->create = [setup = std::move(setup), ...args = std::move(args)]() mutable
+        {
+            T* object = Object::create<T>(std::move(args)...);
+            if (setup)
+                setup(object);
+        };
+        m_pushCommand(command);
+        return command->id;
+    }
+    /// @brief queues the object with the given id to be destroyed on the main thread
+    /// @note this is thread safe and lock free so it can be used from jobs on the ThreadPool
+    /// @note can be used with an id from createDeferred before the object is created
+    static void destroyDeferred(uint64_t id);
+    /// @brief creates and destroys everything queued with createDeferred and destroyDeferred in the order they were queued
+    /// @note this is called by the engine after user code
+    /// @warning must be called on the main thread
+    static void applyDeferredCommands();
+
+    /// @brief if true transform updated events are not called right away
+    /// @note instead every moved object is called once when the transform updates are flushed
+    /// @note disabling this flushes any queued transform updates
+    static void setDeferTransformUpdates(bool defer);
+    static bool isDeferringTransformUpdates();
+    /// @brief calls the transform updated events once for every object that was moved since the last flush
+    /// @note this is called by the engine before the physics update
+    static void flushTransformUpdates();
+    /// @returns the number of transform updated events that were skipped since the object was already queued
+    static uint64_t getCollapsedTransformUpdates();
+    static void resetCollapsedTransformUpdates();
+
 protected:
     static Object::Ptr<> addObject(Object* object);
     static void removeObject(Object* object);
 
     static void addToDestroyQueue(Object* object);
+    /// @brief moves the object from the bucket of its current user type to the bucket of the given type
+    /// @note does not set the user type of the object
+    static void setUserType(Object* object, uint64_t type);
+    /// @brief queues the transform updated events for the given object
+    /// @note thread safe so objects can be moved from parallel updates
+    static void addToTransformUpdateQueue(Object* object);
+    /// @brief destructs the object and returns its memory to where it was allocated from
+    /// @note use this instead of delete so pooled objects are released properly
+    static void releaseObject(Object* object);
 
     friend Object;
+    template <typename T>
+    friend class Object::Ptr;
 
 private:
     inline ObjectManager() = default;
 
-    /// @brief if the comp class is deleted the object will be removed with the id
-    static _objectCompare m_compClass;
-    /// @brief all objects
-    static std::unordered_set<Object*> m_objects;
+    /// @brief a slot in the generational slot map that Object::Ptr validates against
+    /// @note an object id is the slot index in the low 32 bits and the generation in the high 32 bits
+    struct m_objectSlot
+    {
+        Object* object = nullptr;
+        /// @brief incremented every time the object in this slot is removed
+        std::uint32_t generation = 1;
+    };
+
+    /// @brief all objects stored densely, each object knows its own index
+    static std::vector<Object*> m_objects;
+    /// @brief slot 0 is reserved for objects that are not handled by the object manager
+    static std::vector<m_objectSlot> m_slots;
+    static std::vector<std::uint32_t> m_freeSlots;
+    /// @brief every object of each user type stored densely, each object knows its index in its bucket
+    /// @note user type 0 is not stored
+    static std::unordered_map<uint64_t, std::vector<Object*>> m_userTypes;
+    /// @brief the next slot that has never been used
+    /// @note atomic so ids can be reserved from any thread
+    static std::atomic<std::uint32_t> m_nextSlot;
+    /// @brief the id that the next added object should use (0 if none)
+    static uint64_t m_reservedID;
+    /// @brief the number of times the destroy queue has been cleared (once per frame)
+    /// @note objects created before the current frame are fully constructed
+    static std::atomic<std::uint32_t> m_frame;
+
+    /// @brief a create or destroy command queued from any thread
+    struct m_deferredCommand
+    {
+        m_deferredCommand* next = nullptr;
+        uint64_t id = 0;
+        /// @brief creates the object (empty for destroy commands)
+        std::function<void()> create;
+    };
+    /// @brief the last queued command (commands are linked newest to oldest)
+    static std::atomic<m_deferredCommand*> m_deferredCommands;
+
+    /// @brief reserves a slot that has never been used and returns the id an object in it will have
+    /// @note thread safe, slots freed by destroyed objects are only reused on the main thread
+    static uint64_t m_reserveID();
+    /// @note thread safe
+    static void m_pushCommand(m_deferredCommand* command);
+
+    /// @brief collects every object in the subtrees of the given roots (parents before children) into m_destroyBatch
+    static void m_collectDestroyBatch(const std::vector<Object*>& roots);
+    /// @brief keeps the memory of an object released in the current destroy batch to be freed after the batch
+    /// @note called from Object::operator delete
+    /// @returns false if the memory should be freed now
+    static bool m_deferFree(void* memory);
+    /// @brief frees the given heap memory of released objects
+    static void m_freeMemory(const std::vector<void*>& memory);
 
-    static std::list<Object*> m_destroyQueue0;
-    static std::list<Object*> m_destroyQueue1;
+    static std::vector<Object*> m_destroyQueue0;
+    static std::vector<Object*> m_destroyQueue1;
     static bool m_nextQueue;
+    /// @brief every object being destroyed in the current ClearDestroyQueue call (kept to reuse the memory)
+    static std::vector<Object*> m_destroyBatch;
+    static bool m_deferTransformUpdates;
+    /// @brief the ids of the objects that have a transform update queued
+    static std::vector<uint64_t> m_transformUpdateQueue;
+    static uint64_t m_collapsedTransformUpdates;
+    static std::mutex m_transformUpdateQueueLock;
+    /// @brief if the memory of deleted objects is kept in m_heapMemory (only while a destroy batch is released)
+    static bool m_deferHeapFree;
+    /// @brief the heap memory of the objects in the current destroy batch
+    static std::vector<void*> m_heapMemory;
+    /// @brief the minimum number of heap objects before their memory is freed on the thread pool
+    static constexpr std::size_t m_parallelFreeThreshold = 512;
 };
 
+template <typename T>
+inline bool Object::Ptr<T>::m_isAlive() const
+{
+    return m_ptr != nullptr && ObjectManager::m_slots[(std::uint32_t)m_id].generation == (std::uint32_t)(m_id >> 32);
+}
+
+template <typename T>
+inline void Object::Ptr<T>::set(T* rawPtr)
+{
+    if (rawPtr == nullptr || (std::uint32_t)rawPtr->m_id == 0)
+    {
+        m_ptr = nullptr;
+        m_id = 0;
+        return;
+    }
+
+    m_ptr = rawPtr;
+    m_id = rawPtr->m_id;
+}
+
 #endif
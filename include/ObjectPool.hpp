@@ -0,0 +1,113 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/// @brief the type erased part of an object pool so that objects can be released without knowing their type
+class ObjectPoolBase
+{
+public:
+    inline virtual ~ObjectPoolBase() = default;
+
+    /// @brief returns the memory of an already destructed object to this pool
+    /// @warning the memory must have come from this pool
+    virtual void deallocate(void* memory) = 0;
+};
+
+/// @brief slab allocator for a single object type
+/// @note objects of the same type are allocated next to each other in slabs so iterating them stays in cache
+/// @note use Object::create<T>() instead of using this directly
+/// @warning not thread safe
+template <typename T>
+class ObjectPool : public ObjectPoolBase
+{
+public:
+    /// @brief singleton getter (one pool per type)
+    static inline ObjectPool<T>& get()
+    {
+        static ObjectPool<T> pool;
+        return pool;
+    }
+
+    /// @returns uninitialized memory for one T
+    inline void* allocate()
+    {
+        if (m_freeList == nullptr)
+            m_addSlab(m_nextSlabSize);
+
+        m_block* block = m_freeList;
+        m_freeList = block->next;
+        m_used++;
+        return block->storage;
+    }
+
+    inline void deallocate(void* memory) override
+    {
+        m_block* block = static_cast<m_block*>(memory);
+        block->next = m_freeList;
+        m_freeList = block;
+        m_used--;
+    }
+
+    /// @brief makes sure that at least the given number of objects can be allocated without allocating a new slab
+    inline void reserve(std::size_t count)
+    {
+        if (m_capacity - m_used >= count)
+            return;
+        m_addSlab(count - (m_capacity - m_used));
+    }
+
+    /// @returns the number of objects currently allocated from this pool
+    inline std::size_t getNumberOfObjects() const
+    {
+        return m_used;
+    }
+
+    /// @returns the number of objects that fit in the allocated slabs
+    inline std::size_t getCapacity() const
+    {
+        return m_capacity;
+    }
+
+protected:
+    inline ObjectPool() = default;
+    ObjectPool(ObjectPool const&) = delete;
+    void operator=(ObjectPool const&) = delete;
+
+private:
+    union m_block
+    {
+        m_block* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    /// @brief allocates a new slab and pushes its blocks onto the free list in memory order
+    inline void m_addSlab(std::size_t size)
+    {
+        m_slabs.emplace_back(new m_block[size]);
+        m_block* slab = m_slabs.back().get();
+        for (std::size_t i = size; i > 0; i--)
+        {
+            slab[i - 1].next = m_freeList;
+            m_freeList = &slab[i - 1];
+        }
+        m_capacity += size;
+        // grow the slabs with the pool so large pools dont end up with many small slabs
+        if (m_nextSlabSize < m_maxSlabSize)
+            m_nextSlabSize *= 2;
+    }
+
+    static constexpr std::size_t m_maxSlabSize = 4096;
+
+    std::vector<std::unique_ptr<m_block[]>> m_slabs;
+    m_block* m_freeList = nullptr;
+    std::size_t m_nextSlabSize = 64;
+    std::size_t m_capacity = 0;
+    std::size_t m_used = 0;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef OBJECT_TYPE_INFO_HPP
+#define OBJECT_TYPE_INFO_HPP
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <typeinfo>
+
+class UpdateInterface;
+
+/// @brief cached cast results for one most derived object type
+/// @note the offset from the Object base to any other base is the same for every object of the same most derived type
+/// (even through virtual inheritance) so each cast only has to be resolved with dynamic_cast once per type
+/// @note thread safe
+class ObjectTypeInfo
+{
+public:
+    /// @returns the info for the given most derived type
+    static ObjectTypeInfo& get(const std::type_info& type);
+    /// @note also finds the update phases T overrides (see getUpdatePhases)
+    template <typename T>
+    static inline ObjectTypeInfo& get()
+    {
+        static ObjectTypeInfo& info = []() -> ObjectTypeInfo&
+        {
+            ObjectTypeInfo& info = get(typeid(T));
+            info.m_updatePhases.store(m_findUpdatePhases<T>(), std::memory_order_relaxed);
+            return info;
+        }();
+        return info;
+    }
+
+    /// @returns a unique id for the given cast target type (ids are dense and start at 0)
+    template <typename T>
+    static inline std::size_t getTypeID()
+    {
+        static const std::size_t id = m_nextTypeID.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    /// @brief the result of a cast that has not been resolved yet
+    static constexpr std::ptrdiff_t UNKNOWN = PTRDIFF_MIN;
+    /// @brief the result of a cast to a type that the object is not
+    static constexpr std::ptrdiff_t NOT_A = PTRDIFF_MIN + 1;
+    /// @brief the max number of cast target types that are cached, any others always use dynamic_cast
+    static constexpr std::size_t MAX_TYPES = 256;
+
+    /// @returns the byte offset from the Object base to the base with the given type id, UNKNOWN, or NOT_A
+    inline std::ptrdiff_t getOffset(std::size_t typeID) const
+    {
+        return m_offsets[typeID].load(std::memory_order_relaxed);
+    }
+    /// @note every thread would set the same value so no ordering is needed
+    inline void setOffset(std::size_t typeID, std::ptrdiff_t offset)
+    {
+        m_offsets[typeID].store(offset, std::memory_order_relaxed);
+    }
+
+    const std::type_info& getType() const;
+
+    /// @brief every update phase (one bit for each UpdateInterface::Phase)
+    static constexpr std::uint8_t ALL_UPDATE_PHASES = 0b111;
+    /// @returns a bit for each UpdateInterface::Phase this type overrides
+    /// @note ALL_UPDATE_PHASES until the info is found with get<T>() since the overrides can only be known from the static type
+    inline std::uint8_t getUpdatePhases() const
+    {
+        return m_updatePhases.load(std::memory_order_relaxed);
+    }
+
+protected:
+    ObjectTypeInfo(const std::type_info& type);
+    ObjectTypeInfo(ObjectTypeInfo const&) = delete;
+    void operator=(ObjectTypeInfo const&) = delete;
+
+private:
+    /// @returns a bit for each update phase T overrides
+    /// @note a phase that is not overridden is still a member of UpdateInterface, anything else (including an ambiguous override) counts as overridden
+    template <typename T>
+    static constexpr std::uint8_t m_findUpdatePhases()
+    {
+        std::uint8_t phases = ALL_UPDATE_PHASES;
+        if constexpr (requires { requires std::is_same_v<decltype(&T::Update), void (UpdateInterface::*)(float)>; })
+            phases &= ~(1 << 0);
+        if constexpr (requires { requires std::is_same_v<decltype(&T::LateUpdate), void (UpdateInterface::*)(float)>; })
+            phases &= ~(1 << 1);
+        if constexpr (requires { requires std::is_same_v<decltype(&T::FixedUpdate), void (UpdateInterface::*)()>; })
+            phases &= ~(1 << 2);
+        return phases;
+    }
+
+    const std::type_info& m_type;
+    std::atomic<std::ptrdiff_t> m_offsets[MAX_TYPES];
+    std::atomic<std::uint8_t> m_updatePhases = ALL_UPDATE_PHASES;
+
+    static std::atomic<std::size_t> m_nextTypeID;
+};
+
+#endif
@@ -16,6 +16,8 @@
 #include "EngineSettings.hpp"
 
 class CollisionManager;
+class SnapshotWriter;
+class SnapshotReader;
 
 // TODO make a gui editor for making bodies over an image (prints the code that will produce the given effect) (should also be able to load based on given code)
 // TODO make parent and child colliders have defined behaviour
@@ -232,6 +234,13 @@ public:
 	// const b2JointEdge* GetJointList() const;
     Transform getInterpolatedTransform() const override;
 
+    /// @brief writes the body settings and every fixture for scene snapshots (SceneSnapshot)
+    /// @note chain segment fixtures are not written
+    void writeColliderSnapshot(SnapshotWriter& writer) const;
+    /// @brief reads the body settings and fixtures written by writeColliderSnapshot
+    /// @note fixtures that already exist (i.e. made in the constructor) are reused in order while they match the saved fixtures, the rest are replaced
+    void readColliderSnapshot(SnapshotReader& reader);
+
 protected:
 
 private:
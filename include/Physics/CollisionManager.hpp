@@ -22,6 +22,11 @@ public:
 
     /// @brief Make sure to call this every frame after box2d update
     void Update();
+    /// @brief moves the object of every body that moved in the last physics step
+    /// @note called by the WorldHandler after every step
+    void updateBodyTransforms();
+    /// @brief makes sure that the given number of colliders can be added without rehashing
+    void reserve(std::size_t count);
 
 protected:
     /// @brief adds the collider to the manager
@@ -7,6 +7,7 @@
 #include "Vector2.hpp"
 #include <thread>
 #include <atomic>
+#include <functional>
 
 // TODO temp
 class ExplosionDef
@@ -29,7 +30,10 @@ public:
     static WorldHandler& get();
 
     void init(const Vector2& gravity, unsigned int workerCount = std::thread::hardware_concurrency());
-    void updateWorld(double deltaTime);
+    /// @brief steps the world once for every tick that fits in the accumulated time (up to the max updates)
+    /// @note the objects of bodies that moved are updated after every step
+    /// @param onTick called right before every step so anything using it runs at the tick rate (the engine calls FixedUpdate from here)
+    void updateWorld(double deltaTime, const std::function<void()>& onTick = {});
     /// @note only call this before using any physics
     /// @param ticksPerSecond the max number of updates the physics engine will take per second
     void setTickRate(std::int32_t ticksPreSecond = 60);
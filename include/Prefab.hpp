@@ -0,0 +1,72 @@
+#ifndef PREFAB_HPP
+#define PREFAB_HPP
+
+#pragma once
+
+#include <vector>
+
+#include "Object.hpp"
+#include "SceneSnapshot.hpp"
+
+/// @brief an object and its children that are captured once and can then be created any number of times
+/// @note uses the same data as SceneSnapshot so only registered types are captured (see SceneSnapshot for what is stored)
+/// @note creating many copies at once reserves the object pools and managers up front and registers drawables in bulk
+class Prefab
+{
+public:
+    inline Prefab() = default;
+    /// @note check isValid() to see if the object was captured
+    Prefab(Object* root);
+
+    /// @brief captures the given object and its children as they are now
+    /// @returns false if the type of the root is not registered with SceneSnapshot
+    bool capture(Object* root);
+    /// @brief uses the given snapshot data (as saved by SceneSnapshot) as this prefab
+    /// @note the snapshot should have one object without a parent
+    /// @returns false if the data is not a valid snapshot
+    bool load(const void* data, std::size_t size);
+    /// @returns the snapshot data of this prefab so it can be saved
+    const std::vector<char>& getData() const;
+    bool isValid() const;
+    /// @returns the number of objects in each copy
+    std::size_t getNumberOfObjects() const;
+
+    /// @brief creates a copy with the captured transform
+    /// @returns the root of the copy (nullptr if this prefab is not valid)
+    Object* instantiate();
+    /// @brief creates a copy with the given root transform
+    /// @returns the root of the copy (nullptr if this prefab is not valid)
+    Object* instantiate(const Transform& transform);
+    /// @brief creates the given number of copies with the captured transform
+    /// @returns the root of each copy
+    std::vector<Object*> instantiate(std::size_t count);
+    /// @brief creates a copy for each of the given root transforms
+    /// @returns the root of each copy
+    std::vector<Object*> instantiate(const std::vector<Transform>& transforms);
+
+protected:
+
+private:
+    /// @param transforms the transform of each root (nullptr to use the captured transform)
+    std::vector<Object*> m_instantiate(std::size_t count, const Transform* transforms);
+    /// @brief creates a single copy
+    /// @param transform the transform of the root (nullptr to use the captured transform)
+    /// @returns the root of the copy
+    Object* m_createCopy(const Transform* transform);
+    /// @brief counts the objects in the last created copy that are registered with each manager
+    void m_countManaged();
+
+    std::vector<char> m_data;
+    std::vector<std::pair<const SceneSnapshot::m_typeEntry*, std::uint64_t>> m_types;
+    std::vector<SceneSnapshot::m_objectRecord> m_records;
+    /// @brief the objects of the copy being created (kept to reuse the memory)
+    std::vector<Object*> m_objects;
+    std::vector<Object*> m_roots;
+
+    /// @brief if the managed counts have been found from a created copy
+    bool m_counted = false;
+    std::size_t m_updateCount = 0;
+    std::size_t m_colliderCount = 0;
+};
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef SCENE_SNAPSHOT_HPP
+#define SCENE_SNAPSHOT_HPP
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <typeindex>
+#include <chrono>
+
+#include "Object.hpp"
+#include "SnapshotStream.hpp"
+
+/// @brief saves and loads the object hierarchy to and from a versioned binary format
+/// @note only objects with a registered type are saved, the children of an object that is not saved are skipped as well
+/// @note for every object the hierarchy, local transform, user type, and enabled state are saved
+/// @note loaded objects are constructed with their parent, transform, and user type already set so no parent or transform events are called for them
+/// @note if the type has the matching functions the following are also saved (in this order):
+/// @note - collider body and fixtures (Collider::writeColliderSnapshot/readColliderSnapshot)
+/// @note - renderer shape parameters (Renderer::writeRendererSnapshot/readRendererSnapshot)
+/// @note - any custom data (writeSnapshot(SnapshotWriter&) const and readSnapshot(SnapshotReader&))
+class Prefab;
+
+class SceneSnapshot
+{
+private:
+    struct m_typeEntry;
+    struct m_objectRecord;
+
+public:
+    /// @brief snapshots with a different version can not be loaded
+    static constexpr std::uint32_t VERSION = 1;
+
+    /// @brief registers a type so it can be saved and loaded
+    /// @note the type must be default constructible, it is created with Object::create<T>()
+    /// @param name the name stored in the snapshot (must be unique and should not change between versions of your game)
+    template <typename T>
+    static inline void registerType(const std::string& name)
+    {
+        static_assert(std::is_base_of_v<Object, T>, "Only types that derive from Object can be registered");
+        m_typeEntry& entry = m_getTypes()[std::type_index(typeid(T))];
+        entry.name = name;
+        entry.create = [](){ return static_cast<Object*>(Object::create<T>()); };
+        entry.reserve = [](std::size_t count){ ObjectPool<T>::get().reserve(count); };
+        entry.write = &SceneSnapshot::m_write<T>;
+        entry.read = &SceneSnapshot::m_read<T>;
+    }
+
+    /// @brief saves every object without a parent (and its children)
+    /// @returns false if writing failed
+    static bool save(std::ostream& stream);
+    /// @brief saves the given objects and their children
+    /// @returns false if writing failed
+    static bool save(std::ostream& stream, const std::vector<Object*>& roots);
+    /// @returns false if the file could not be written
+    static bool save(const std::string& filePath);
+
+    /// @note objects with a type that is not registered are skipped along with their children
+    /// @returns the loaded objects without a parent (empty if the snapshot is invalid)
+    static std::vector<Object*> load(std::istream& stream);
+    /// @returns the loaded objects without a parent (empty if the file could not be read)
+    static std::vector<Object*> load(const std::string& filePath);
+
+    /// @brief a snapshot that is decoded up front and then created a few objects at a time
+    /// @note decoding does not touch any objects so it can be done on any thread
+    /// @note created objects can be destroyed between calls, the records of destroyed parents are skipped
+    /// @warning types should not be registered while decoding on another thread
+    class IncrementalLoad
+    {
+    public:
+        /// @brief copies the data and reads every object record (type data is read when the object is created)
+        /// @note objects created by a previous load are kept
+        /// @returns false if the data is not a valid snapshot
+        bool decode(const void* data, std::size_t size);
+        /// @brief creates objects until everything is created or the deadline is reached
+        /// @note at least one object is created every call
+        /// @returns true if every object has been created
+        bool instantiate(std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+        /// @returns true if every object has been created
+        bool isDone() const;
+        /// @returns the created objects without a parent (some may have been destroyed since)
+        const std::vector<Object::Ptr<>>& getRoots() const;
+        /// @brief destroys every created root that still exists and does not have a parent and clears all decoded data
+        void cancel();
+
+    private:
+        void m_clear();
+
+        std::vector<char> m_data;
+        /// @brief the type of each type index and the number of objects of that type
+        std::vector<std::pair<const m_typeEntry*, std::uint64_t>> m_types;
+        std::vector<m_objectRecord> m_records;
+        /// @brief the id of the object created for each record (0 if skipped)
+        /// @note ids are stored since the objects can be destroyed between calls to instantiate
+        std::vector<std::uint64_t> m_objects;
+        std::vector<Object::Ptr<>> m_roots;
+        std::size_t m_next = 0;
+    };
+
+protected:
+    friend Prefab;
+
+private:
+    inline SceneSnapshot() = default;
+
+    struct m_typeEntry
+    {
+        std::string name;
+        Object* (*create)() = nullptr;
+        void (*reserve)(std::size_t) = nullptr;
+        void (*write)(const Object&, SnapshotWriter&) = nullptr;
+        void (*read)(Object&, SnapshotReader&) = nullptr;
+    };
+
+    /// @brief everything stored for an object besides its type data
+    struct m_objectRecord
+    {
+        /// @brief nullptr if the type is not registered
+        const m_typeEntry* entry = nullptr;
+        std::uint32_t parent = 0;
+        Transform transform;
+        std::uint64_t userType = 0;
+        bool enabled = true;
+        /// @brief the position of the type data in the snapshot
+        std::uint64_t dataOffset = 0;
+        std::uint32_t dataSize = 0;
+    };
+
+    template <typename T>
+    static inline void m_write(const Object& object, SnapshotWriter& writer)
+    {
+        const T& obj = *object.cast<T>();
+        if constexpr (requires(const T& t, SnapshotWriter& w) { t.writeColliderSnapshot(w); })
+            obj.writeColliderSnapshot(writer);
+        if constexpr (requires(const T& t, SnapshotWriter& w) { t.writeRendererSnapshot(w); })
+            obj.writeRendererSnapshot(writer);
+        if constexpr (requires(const T& t, SnapshotWriter& w) { t.writeSnapshot(w); })
+            obj.writeSnapshot(writer);
+    }
+
+    template <typename T>
+    static inline void m_read(Object& object, SnapshotReader& reader)
+    {
+        T& obj = *object.cast<T>();
+        if constexpr (requires(T& t, SnapshotReader& r) { t.readColliderSnapshot(r); })
+            obj.readColliderSnapshot(reader);
+        if constexpr (requires(T& t, SnapshotReader& r) { t.readRendererSnapshot(r); })
+            obj.readRendererSnapshot(reader);
+        if constexpr (requires(T& t, SnapshotReader& r) { t.readSnapshot(r); })
+            obj.readSnapshot(reader);
+    }
+
+    /// @returns nullptr if the type of the object is not registered
+    static const m_typeEntry* m_getEntry(const Object& object);
+    /// @brief reads the magic, version, and type table
+    /// @param types the type of each type index (nullptr if not registered) and the number of objects of that type
+    /// @returns false if this is not a valid snapshot
+    static bool m_readHeader(SnapshotReader& reader, std::vector<std::pair<const m_typeEntry*, std::uint64_t>>& types);
+    /// @brief reads an object record and starts the block with its type data
+    /// @note the block has to be ended once the type data is read
+    static m_objectRecord m_readRecord(SnapshotReader& reader, const std::vector<std::pair<const m_typeEntry*, std::uint64_t>>& types);
+    /// @brief reads every object record in the given snapshot (type data is read when the object is created)
+    /// @note does not touch any objects so this can be called on any thread
+    /// @returns false if the data is not a valid snapshot
+    static bool m_decode(const std::vector<char>& data, std::vector<std::pair<const m_typeEntry*, std::uint64_t>>& types, std::vector<m_objectRecord>& records);
+    /// @brief creates the object with everything stored in its record (besides type data)
+    /// @note the parent, transform, and user type are set before the constructor of the type runs so no events are called for them
+    /// @param parent nullptr if the object has no parent
+    static Object* m_createObject(const m_objectRecord& record, Object* parent);
+    /// @brief creates the object with everything stored in its record (besides type data)
+    /// @param objects every object that was created for the records before this one (nullptr if skipped)
+    /// @param roots created objects without a parent are added to this
+    /// @returns nullptr if the type is not registered or the parent was skipped
+    static Object* m_createObject(const m_objectRecord& record, const std::vector<Object*>& objects, std::vector<Object*>& roots);
+
+    /// @note function static so types can be registered during static initialization
+    static std::unordered_map<std::type_index, m_typeEntry>& m_getTypes();
+};
+
+#endif
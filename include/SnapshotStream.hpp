@@ -0,0 +1,113 @@
+#ifndef SNAPSHOT_STREAM_HPP
+#define SNAPSHOT_STREAM_HPP
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// @brief buffered binary writer used for scene snapshots
+/// @note values are written in the native byte order
+class SnapshotWriter
+{
+public:
+    SnapshotWriter(std::ostream& stream);
+    /// @note flushes any remaining data
+    ~SnapshotWriter();
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    void operator=(const SnapshotWriter&) = delete;
+
+    void writeBytes(const void* data, std::size_t size);
+    /// @note only for trivially copyable types
+    template <typename T>
+    inline void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written directly");
+        writeBytes(&value, sizeof(T));
+    }
+    void writeString(const std::string& str);
+
+    /// @brief starts a block that is prefixed with its size so a reader can skip it
+    /// @note blocks can not be nested
+    void beginBlock();
+    void endBlock();
+
+    /// @brief writes all buffered data to the stream
+    /// @note this is done automatically when the buffer is full and not in a block
+    void flush();
+    /// @returns false if the stream failed
+    bool isValid() const;
+
+private:
+    static constexpr std::size_t m_flushSize = 1 << 16;
+
+    std::ostream& m_stream;
+    std::vector<char> m_buffer;
+    /// @brief the offset of the size of the current block (SIZE_MAX if not in a block)
+    std::size_t m_blockStart = SIZE_MAX;
+};
+
+/// @brief buffered binary reader used for scene snapshots
+/// @note once a read fails every following read returns zeroed data and isValid() returns false
+class SnapshotReader
+{
+public:
+    SnapshotReader(std::istream& stream);
+    /// @brief reads directly from the given memory without buffering
+    /// @warning the memory must stay valid as long as this reader is used
+    SnapshotReader(const void* data, std::size_t size);
+    SnapshotReader(const SnapshotReader&) = delete;
+    void operator=(const SnapshotReader&) = delete;
+
+    /// @returns false if there was not enough data
+    bool readBytes(void* data, std::size_t size);
+    /// @note only for trivially copyable types
+    template <typename T>
+    inline T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read directly");
+        T value;
+        if (!readBytes(&value, sizeof(T)))
+            std::memset(&value, 0, sizeof(T));
+        return value;
+    }
+    std::string readString();
+
+    /// @brief starts reading a block written with SnapshotWriter::beginBlock
+    /// @returns the size of the block
+    std::uint32_t beginBlock();
+    /// @brief skips anything in the current block that was not read
+    void endBlock();
+
+    /// @returns the number of bytes read so far (including skipped bytes)
+    std::uint64_t getPosition() const;
+    /// @returns false if any read failed
+    bool isValid() const;
+
+private:
+    /// @returns false if the stream did not have enough data
+    bool m_fill(std::size_t size);
+    void m_skip(std::size_t size);
+
+    static constexpr std::size_t m_readSize = 1 << 16;
+
+    /// @brief nullptr if reading from memory
+    std::istream* m_stream = nullptr;
+    std::vector<char> m_buffer;
+    /// @brief the data being read (either the buffer or the given memory)
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_position = 0;
+    /// @brief the total number of bytes consumed
+    std::uint64_t m_consumed = 0;
+    /// @brief the consumed count where the current block ends (UINT64_MAX if not in a block)
+    std::uint64_t m_blockEnd = UINT64_MAX;
+    bool m_valid = true;
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef TRANSFORM_STORE_HPP
+#define TRANSFORM_STORE_HPP
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <atomic>
+
+#include "Transform.hpp"
+
+class Object;
+
+/// @brief stores the local transform of every object in contiguous arrays (structure of arrays)
+/// @note objects refer to their transform by index so bulk systems can stream through all transforms linearly
+/// @note the order changes when objects are removed (the last transform is moved into the removed index)
+/// @note the hierarchy is also kept as a flat list ordered by depth (parents before children) so global transforms can be computed in one pass
+/// @warning read only outside of Object, use the Object setters so dirty flags and events are handled
+class TransformStore
+{
+public:
+    /// @brief the parent index of a transform that has no parent
+    static constexpr std::uint32_t NO_PARENT = UINT32_MAX;
+    /// @brief depths with fewer transforms than this are not split across the thread pool
+    static constexpr std::size_t MIN_PARALLEL_DEPTH_SIZE = 2048;
+
+    /// @returns the number of stored transforms
+    static std::size_t size();
+    /// @brief makes sure that the given number of transforms can be added without reallocating
+    static void reserve(std::size_t count);
+
+    static const std::vector<float>& getPositionsX();
+    static const std::vector<float>& getPositionsY();
+    static const std::vector<float>& getRotationsCos();
+    static const std::vector<float>& getRotationsSin();
+    /// @returns the index of the parents transform for every transform (NO_PARENT if none)
+    static const std::vector<std::uint32_t>& getParents();
+    /// @returns the object that owns each transform
+    static const std::vector<Object*>& getOwners();
+
+    static inline Transform get(std::uint32_t index)
+    {
+        return Transform(Vector2{m_positionX[index], m_positionY[index]}, Rotation{m_rotationCos[index], m_rotationSin[index]});
+    }
+    static inline Vector2 getPosition(std::uint32_t index)
+    {
+        return Vector2{m_positionX[index], m_positionY[index]};
+    }
+    static inline Rotation getRotation(std::uint32_t index)
+    {
+        return Rotation{m_rotationCos[index], m_rotationSin[index]};
+    }
+
+    /// @brief computes the global transform of every transform in one pass over the hierarchy order
+    /// @note each depth only depends on the depth before it so large depths are split across the thread pool
+    /// @note called by the engine before the physics update and before drawing
+    /// @param interpolate if true the interpolated global transforms (from getInterpolatedTransform) are also computed
+    /// @note the interpolated transforms are recomputed every call since they change even when no transform is set
+    /// @warning when interpolating, getInterpolatedTransform is called from the thread pool so it should only read
+    static void updateGlobalTransforms(bool interpolate = false);
+    /// @returns true if no transform has changed since the global transforms were last computed
+    static bool areGlobalTransformsValid();
+    /// @returns true if no transform has changed since the interpolated global transforms were last computed
+    /// @note the interpolated transforms are only up to date for the interpolation time they were computed with
+    static bool areInterpolatedTransformsValid();
+    /// @note only valid if areGlobalTransformsValid is true
+    static inline Transform getGlobal(std::uint32_t index)
+    {
+        return m_global[index];
+    }
+    /// @returns the global transform from the last updateGlobalTransforms call even if it has changed since
+    /// @note the local transform is returned if the transform was added after the last call
+    /// @note only reads so it is safe to call from the thread pool while updating
+    static inline Transform getLastGlobal(std::uint32_t index)
+    {
+        return index < m_global.size() ? m_global[index] : get(index);
+    }
+    /// @note only valid if areInterpolatedTransformsValid is true
+    static inline Transform getInterpolatedGlobal(std::uint32_t index)
+    {
+        return m_interpolatedGlobal[index];
+    }
+    /// @returns every transform index ordered by depth (parents before children)
+    static const std::vector<std::uint32_t>& getHierarchyOrder();
+    /// @returns where each depth starts in the hierarchy order (the last element is the number of transforms)
+    static const std::vector<std::uint32_t>& getDepthBands();
+
+protected:
+    /// @returns the index of the new transform
+    static std::uint32_t add(Object* owner);
+    /// @brief removes the transform by moving the last transform into its place
+    static void remove(std::uint32_t index);
+
+    static inline void set(std::uint32_t index, const Transform& transform)
+    {
+        setPosition(index, transform.position);
+        setRotation(index, transform.rotation);
+    }
+    static inline void setPosition(std::uint32_t index, const Vector2& position)
+    {
+        m_invalidateGlobals();
+        m_positionX[index] = position.x;
+        m_positionY[index] = position.y;
+    }
+    static inline void setRotation(std::uint32_t index, Rotation rotation)
+    {
+        m_invalidateGlobals();
+        m_rotationCos[index] = rotation.cos;
+        m_rotationSin[index] = rotation.sin;
+    }
+    static inline void setParent(std::uint32_t index, std::uint32_t parent)
+    {
+        m_invalidateGlobals();
+        m_hierarchyDirty = true;
+        m_parent[index] = parent;
+    }
+
+    friend Object;
+
+private:
+    inline TransformStore() = default;
+
+    /// @note only stores if valid so moving objects from parallel updates does not keep writing the same value
+    static inline void m_invalidateGlobals()
+    {
+        if (m_globalsValid.load(std::memory_order_relaxed))
+            m_globalsValid.store(false, std::memory_order_relaxed);
+        if (m_interpolatedValid.load(std::memory_order_relaxed))
+            m_interpolatedValid.store(false, std::memory_order_relaxed);
+    }
+    /// @brief sorts every transform by depth
+    static void m_updateHierarchyOrder();
+    /// @brief computes the global transforms in the given range of the hierarchy order
+    static void m_updateGlobalRange(std::uint32_t start, std::uint32_t end, bool interpolate);
+
+    static std::vector<float> m_positionX;
+    static std::vector<float> m_positionY;
+    static std::vector<float> m_rotationCos;
+    static std::vector<float> m_rotationSin;
+    static std::vector<std::uint32_t> m_parent;
+    static std::vector<Object*> m_owner;
+
+    /// @brief the global transform of each transform (by index not hierarchy order)
+    static std::vector<Transform> m_global;
+    static std::vector<Transform> m_interpolatedGlobal;
+    static std::vector<std::uint32_t> m_hierarchyOrder;
+    static std::vector<std::uint32_t> m_depthBands;
+    /// @brief the depth of each transform, only used while sorting
+    static std::vector<std::uint32_t> m_depth;
+    static bool m_hierarchyDirty;
+    static std::atomic<bool> m_globalsValid;
+    static std::atomic<bool> m_interpolatedValid;
+};
+
+#endif
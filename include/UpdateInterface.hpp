@@ -3,30 +3,126 @@
 
 #pragma once
 
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+
 #include "Object.hpp"
 
+class UpdateManager;
+
 class UpdateInterface : public virtual Object
 {
 public:
     using Ptr = Object::Ptr<UpdateInterface>;
 
+    /// @brief the update phases that UpdateManager keeps a list of objects for
+    enum class Phase : std::uint8_t
+    {
+        Update,
+        LateUpdate,
+        FixedUpdate,
+        Count
+    };
+
     UpdateInterface();
     virtual ~UpdateInterface();
 
     /// @brief called every frame
+    /// @note objects of a registered type that does not override this are not kept in the update list (see registerType)
     virtual void Update(float deltaTime);
     /// @brief called every frame after update
+    /// @note objects of a registered type that does not override this are not kept in the late update list (see registerType)
     virtual void LateUpdate(float deltaTime);
     /// @brief called a fixed amount of times per second
+    /// @note called once before every physics step so the time between calls is always 1 / WorldHandler::getTickRate()
+    /// @note objects of a registered type that does not override this are not kept in the fixed update list (see registerType)
     virtual void FixedUpdate();
     /// @brief called right before window opens
     /// @note called even if the object is disabled
     virtual void Start();
 
+    /// @brief if true Update, LateUpdate, and FixedUpdate are called from the thread pool at the same time as other thread safe objects
+    /// @note false by default
+    /// @note transform updated events from these updates are called on the main thread once every thread safe object is updated
+    /// @warning only use this if the updates only change this object and its children and do not read other objects that could be changed at the same time
+    /// @warning objects must be created and destroyed with ObjectManager::createDeferred and ObjectManager::destroyDeferred from these updates
+    /// @warning should not be called from a thread safe update
+    void setThreadSafeUpdate(bool threadSafe = true);
+    bool isThreadSafeUpdate() const;
+    /// @brief this object is updated once every given number of frames (at least 1)
+    /// @note Update and LateUpdate are given the time since they were last called, FixedUpdate is not throttled
+    void setUpdateInterval(std::uint32_t frames);
+    std::uint32_t getUpdateInterval() const;
+    /// @brief this object is updated about once every given number of seconds (0 to only use the interval in frames)
+    /// @note changed to an interval in frames from the average frame time
+    void setUpdateIntervalSeconds(float seconds);
+    float getUpdateIntervalSeconds() const;
+    /// @brief if true this object is updated less often the further it is from the main camera (see UpdateManager::setLODLevels)
+    /// @note the interval is never less than the set interval
+    void setUpdateLOD(bool lod = true);
+    bool isUpdateLOD() const;
+    /// @returns the interval in frames this object is currently updated at
+    std::uint32_t getCurrentUpdateInterval() const;
+    /// @brief moves this object into the given update group (created with priority 0 if it does not exist)
+    /// @note objects are in the default group until this is called (see UpdateManager::setGroupPriority)
+    void setUpdateGroup(const std::string& group);
+    const std::string& getUpdateGroup() const;
+
+    /// @brief finds which update phases the given type overrides so its objects are only listed for those phases
+    /// @note types created with Object::create are registered automatically, only needed for objects created with "new"
+    /// @note objects of types that are not registered are listed for every phase
+    /// @tparam T the most derived type of the objects
+    template <typename T>
+    static inline void registerType()
+    {
+        static_assert(std::is_base_of_v<UpdateInterface, T>, "Only types that derive from UpdateInterface can be registered");
+        ObjectTypeInfo::get<T>();
+    }
+
 protected:
 
 private:
+    /// @brief the list index of a phase this object is not in
+    static constexpr std::size_t NOT_LISTED = SIZE_MAX;
+
+    /// @brief adds or removes this object from the update lists when it is enabled or disabled
+    void m_updateLists();
 
+    bool m_threadSafe = false;
+    /// @brief if this object is in the thread safe lists of the UpdateManager
+    bool m_inThreadSafeLists = false;
+    /// @brief the index of the update group of this object
+    std::uint32_t m_group = 0;
+    /// @brief the index of the update group this object is listed in
+    std::uint32_t m_listedGroup = 0;
+    std::uint32_t m_intervalFrames = 1;
+    float m_intervalSeconds = 0;
+    bool m_lod = false;
+    /// @brief the interval this object should be updated at
+    std::uint32_t m_interval = 1;
+    /// @brief the interval of the lists this object is in
+    std::uint32_t m_listedInterval = 1;
+    /// @brief the bucket of the interval this object is in
+    std::uint32_t m_listedBucket = 0;
+    /// @brief the phase time of the UpdateManager when each phase last updated this object
+    double m_lastUpdate[(std::size_t)Phase::Count] = {};
+    /// @brief the most derived type of this object so lists can be sorted by type
+    /// @note nullptr until this object is first sorted (the type is not known while constructing)
+    const std::type_info* m_type = nullptr;
+    /// @brief if this object is waiting for its lists to be updated
+    bool m_listsQueued = false;
+    /// @brief a bit for each phase this object overrides
+    /// @note every phase until the type of this object is resolved by the UpdateManager
+    std::uint8_t m_overrides = ObjectTypeInfo::ALL_UPDATE_PHASES;
+    /// @brief the index in every object of the UpdateManager
+    std::size_t m_index = 0;
+    /// @brief the index in the list of each phase
+    std::size_t m_listIndex[(std::size_t)Phase::Count] = {NOT_LISTED, NOT_LISTED, NOT_LISTED};
+
+    friend UpdateManager;
 };
 
+static_assert((1 << (std::size_t)UpdateInterface::Phase::Count) - 1 == ObjectTypeInfo::ALL_UPDATE_PHASES, "ObjectTypeInfo has a bit for each update phase");
+
 #endif
@@ -3,64 +3,193 @@
 
 #pragma once
 
-#include <unordered_set>
-
-// #include "BS_thread_pool.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "UpdateInterface.hpp"
 
 class UpdateInterface;
 
+/// @brief calls the updates of every UpdateInterface
+/// @note objects are split into named update groups that are updated in order of priority
+/// @note each group has a contiguous list for each update phase that only has the enabled objects that override that phase
+/// so the cost of each phase only depends on the objects that do something in it
+/// @note each list is sorted by the type of the objects so every object of the same type is updated back to back
+/// @note objects with thread safe updates have their own lists and are updated on the thread pool before every other object in their group
+/// @note throttled objects are spread evenly over the frames of their interval so each frame updates about the same number of objects
 class UpdateManager
 {
 public:
-    // /// @brief called once every frame
-    // static void Update(float deltaTime, BS::thread_pool& pool);
-    // /// @brief called after update
-    // static void LateUpdate(float deltaTime, BS::thread_pool& pool);
-    // /// @brief called up to 50 times a second
-    // static void FixedUpdate(BS::thread_pool& pool);
-    // /// @brief called just before opening the window
-    // static void Start(BS::thread_pool& pool);
-
-    /// @note use this for single threaded updates
-    static inline void Update(float deltaTime)
-    {
-        _update(deltaTime, m_objects.begin(), m_objects.end());
-    }
-    /// @note use this for single threaded updates
-    static inline void LateUpdate(float deltaTime)
-    {
-        _lateUpdate(deltaTime, m_objects.begin(), m_objects.end());
-    }
-    /// @note use this for single threaded updates
-    static inline void FixedUpdate()
-    {
-        _fixedUpdate(m_objects.begin(), m_objects.end());
-    }
-    /// @note use this for single threaded updates
-    static inline void Start()
-    {
-        _start(m_objects.begin(), m_objects.end());
-    }
+    /// @brief the group every object starts in (priority 0)
+    static constexpr const char* DEFAULT_GROUP = "Default";
+
+    /// @brief called once every frame
+    static void Update(float deltaTime);
+    /// @brief called after update
+    static void LateUpdate(float deltaTime);
+    /// @brief called a fixed amount of times per second
+    /// @note the engine calls this once before every physics step (see WorldHandler::setTickRate)
+    static void FixedUpdate();
+    /// @brief called just before opening the window
+    /// @note every object is started on the main thread
+    static void Start();
+
+    /// @brief creates the update group if it does not exist and sets its priority
+    /// @note groups with a lower priority are updated first, groups with the same priority are updated in the order they were created
+    /// @note if called while updating the new order is used from the next phase
+    static void setGroupPriority(const std::string& group, int priority);
+    /// @returns the priority of the given group (0 if it does not exist)
+    static int getGroupPriority(const std::string& group);
+    /// @returns the name of every group in the order they are updated
+    static std::vector<std::string> getGroups();
+
+    /// @brief sets the update interval used by objects with LOD enabled from their distance to the main camera
+    /// @param levels pairs of distance and interval, objects at least the distance away are updated at most once every interval frames
+    /// @note the default is every 2 frames from 100, every 4 from 200, and every 8 from 400
+    static void setLODLevels(const std::vector<std::pair<float, std::uint32_t>>& levels);
+    static const std::vector<std::pair<float, std::uint32_t>>& getLODLevels();
 
     static size_t getNumberOfObjects();
+    /// @returns the number of objects that are updated on the thread pool
+    static size_t getNumberOfThreadSafeObjects();
+    /// @returns the number of objects that are called in the given phase (enabled and override the phase)
+    static size_t getNumberOfActiveObjects(UpdateInterface::Phase phase);
+    /// @brief makes sure that the given number of objects can be added to the default group without reallocating
+    static void reserve(std::size_t count);
+
+    /// @brief if false thread safe objects are also updated on the main thread
+    /// @note true by default
+    static void setParallelEnabled(bool enabled = true);
+    static bool isParallelEnabled();
+    /// @brief thread safe objects are split into chunks of this size and each thread takes the next chunk until none are left
+    /// @note smaller chunks balance uneven updates better but take more from the shared counter
+    static void setParallelChunkSize(std::size_t size);
+    static std::size_t getParallelChunkSize();
+    /// @returns true while thread safe objects are being updated on the thread pool
+    static bool isUpdatingInParallel();
 
 protected:
     static void addUpdateObject(UpdateInterface* obj);
     static void removeUpdateObject(UpdateInterface* obj);
-
-    static void _update(float deltaTime, std::unordered_set<UpdateInterface*>::iterator begin, std::unordered_set<UpdateInterface*>::iterator end);
-    static void _lateUpdate(float deltaTime, std::unordered_set<UpdateInterface*>::iterator begin, std::unordered_set<UpdateInterface*>::iterator end);
-    static void _fixedUpdate(std::unordered_set<UpdateInterface*>::iterator begin, std::unordered_set<UpdateInterface*>::iterator end);
-    static void _start(std::unordered_set<UpdateInterface*>::iterator begin, std::unordered_set<UpdateInterface*>::iterator end);
+    /// @brief moves the object between the main thread lists and the thread safe lists
+    static void setThreadSafe(UpdateInterface* obj, bool threadSafe);
+    /// @brief moves the object into the lists of the given group
+    static void setGroup(UpdateInterface* obj, const std::string& group);
+    /// @brief sets the update interval of the object and moves it to the lists for the interval
+    static void setInterval(UpdateInterface* obj, std::uint32_t frames, float seconds, bool lod);
+    /// @brief adds or removes the object from each phase list to match its state
+    /// @note changes are queued while any phase is being updated
+    static void updateLists(UpdateInterface* obj);
 
     friend UpdateInterface;
 
 private:
     inline UpdateManager() = default;
 
-    static std::unordered_set<UpdateInterface*> m_objects;
+    static constexpr std::size_t PHASES = (std::size_t)UpdateInterface::Phase::Count;
+
+    struct m_list
+    {
+        std::vector<UpdateInterface*> objects;
+        /// @brief the objects before this index are sorted by type
+        std::size_t sorted = 0;
+        /// @brief if any object was removed (leaving an empty entry)
+        bool needsCompact = false;
+    };
+
+    struct m_bucket
+    {
+        /// @brief the objects that are updated on the main thread in each phase
+        m_list lists[PHASES];
+        /// @brief the objects that are updated on the thread pool in each phase
+        m_list threadSafeLists[PHASES];
+    };
+
+    /// @brief the lists of every object with the same update interval
+    struct m_intervalLists
+    {
+        std::uint32_t interval = 1;
+        /// @brief one bucket is updated each frame (the frame count modulo the interval)
+        std::vector<m_bucket> buckets;
+        /// @brief the bucket the next object is put in (round robin)
+        std::uint32_t nextBucket = 0;
+    };
+
+    struct m_group
+    {
+        std::string name;
+        int priority = 0;
+        /// @brief sorted by interval so the lists that are updated every frame are first
+        /// @note fixed updates are always in the lists that are updated every time
+        std::vector<m_intervalLists> intervals;
+    };
+
+    /// @brief updates every group in order for the given phase
+    /// @note objects are given the time since they were last updated
+    template <typename Function>
+    static void m_updatePhase(std::size_t phase, float deltaTime, const Function& function);
+    /// @brief calls the given function for every enabled thread safe object in the list
+    /// @note the main thread also takes chunks while waiting for the thread pool
+    template <typename Function>
+    static void m_parallelUpdate(std::vector<UpdateInterface*>& list, const Function& function);
+    /// @brief calls the given function for every enabled object in the list
+    template <typename Function>
+    static void m_serialUpdate(std::vector<UpdateInterface*>& list, const Function& function);
+    /// @brief removes empty entries and sorts the objects added since the last update by type
+    static void m_prepare(m_list& list, std::size_t phase);
+    /// @brief finds the type of the object and removes it from the lists of the phases it does not override
+    static void m_resolveType(UpdateInterface* obj);
+    /// @brief applies the changes that were queued while updating
+    static void m_applyQueued();
+    static void m_updateLists(UpdateInterface* obj);
+    /// @brief leaves an empty entry so the order of the list does not change
+    static void m_removeFromList(UpdateInterface* obj, std::size_t phase);
+    /// @returns the list the object is in for the given phase
+    static m_list& m_getList(UpdateInterface* obj, std::size_t phase);
+    /// @returns the lists for the given interval in the group (creating them if needed)
+    static m_intervalLists& m_getIntervalLists(m_group& group, std::uint32_t interval);
+    /// @brief finds the interval of the object from its settings (and the camera distance if it uses LOD)
+    /// @note called after the object is updated if the interval can change
+    static void m_updateInterval(UpdateInterface* obj);
+    /// @returns the index of the group (creating it if needed)
+    /// @note groups created while updating are not updated until the current phase is done
+    /// @warning lock m_queueLock while updating in parallel
+    static std::uint32_t m_getGroup(const std::string& group);
+    /// @brief puts every group in m_groupOrder sorted by priority (in the order they were created for the same priority)
+    static void m_sortGroups();
+
+    /// @brief every object (used for Start)
+    static std::vector<UpdateInterface*> m_objects;
+    static std::vector<std::unique_ptr<m_group>> m_groups;
+    /// @brief every group in the order they are updated
+    /// @note only changed when not updating since it is iterated while updating
+    static std::vector<m_group*> m_groupOrder;
+    /// @brief if a group was created or its priority changed while updating
+    static bool m_groupOrderDirty;
+    static std::unordered_map<std::string, std::uint32_t> m_groupIndex;
+    static std::size_t m_activeCount[PHASES];
+    static std::size_t m_threadSafeCount;
+    /// @brief true while any phase is being updated
+    static bool m_updating;
+    /// @brief objects whose lists changed while updating
+    static std::vector<UpdateInterface*> m_queued;
+    /// @note only used while updating in parallel (also guards creating groups)
+    static std::mutex m_queueLock;
+    /// @brief the total time given to each phase
+    static double m_time[PHASES];
+    /// @brief the number of times each phase was updated
+    static std::uint64_t m_frame[PHASES];
+    static float m_averageDeltaTime;
+    static std::vector<std::pair<float, std::uint32_t>> m_lodLevels;
+    static bool m_hasCamera;
+    static Vector2 m_cameraPosition;
+    static bool m_parallelEnabled;
+    static std::size_t m_parallelChunkSize;
+    static bool m_updatingInParallel;
 };
 
 #endif
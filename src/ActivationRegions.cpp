@@ -0,0 +1,242 @@
+#include "ActivationRegions.hpp"
+#include "ObjectManager.hpp"
+#include "Graphics/CameraManager.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+float ActivationRegions::m_cellSize = 32;
+float ActivationRegions::m_activationDistance = 64;
+float ActivationRegions::m_suspensionDistance = 96;
+bool ActivationRegions::m_mainCameraActivator = true;
+std::unordered_map<std::uint64_t, ActivationRegions::m_cell> ActivationRegions::m_cells;
+std::unordered_map<std::uint64_t, ActivationRegions::m_location> ActivationRegions::m_locations;
+std::vector<Object::Ptr<>> ActivationRegions::m_activators;
+std::vector<Vector2> ActivationRegions::m_activatorPositions;
+
+void ActivationRegions::setCellSize(float size)
+{
+    if (size <= 0 || size == m_cellSize)
+        return;
+    m_cellSize = size;
+
+    std::vector<std::uint64_t> objects;
+    objects.reserve(m_locations.size());
+    for (auto& cell: m_cells)
+    {
+        objects.insert(objects.end(), cell.second.objects.begin(), cell.second.objects.end());
+    }
+    m_cells.clear();
+    m_locations.clear();
+    m_updateActivatorPositions();
+    for (std::uint64_t id: objects)
+    {
+        if (Object* object = ObjectManager::getObjectRaw(id))
+            m_addToCell(object, m_getCellKey(object->getGlobalPosition()));
+    }
+}
+
+float ActivationRegions::getCellSize()
+{
+    return m_cellSize;
+}
+
+void ActivationRegions::setActivationDistance(float distance)
+{
+    m_activationDistance = std::max(distance, 0.f);
+    m_suspensionDistance = std::max(m_suspensionDistance, m_activationDistance);
+}
+
+float ActivationRegions::getActivationDistance()
+{
+    return m_activationDistance;
+}
+
+void ActivationRegions::setSuspensionDistance(float distance)
+{
+    m_suspensionDistance = std::max(distance, m_activationDistance);
+}
+
+float ActivationRegions::getSuspensionDistance()
+{
+    return m_suspensionDistance;
+}
+
+void ActivationRegions::setMainCameraActivator(bool activator)
+{
+    m_mainCameraActivator = activator;
+}
+
+bool ActivationRegions::isMainCameraActivator()
+{
+    return m_mainCameraActivator;
+}
+
+void ActivationRegions::addObject(Object* object)
+{
+    if (object == nullptr || m_locations.contains(object->getID()))
+        return;
+    m_updateActivatorPositions();
+    m_addToCell(object, m_getCellKey(object->getGlobalPosition()));
+}
+
+void ActivationRegions::removeObject(Object* object)
+{
+    if (object == nullptr)
+        return;
+    auto location = m_locations.find(object->getID());
+    if (location == m_locations.end())
+        return;
+
+    m_removeFromCell(m_cells[location->second.cell], location->second.index);
+    object->m_setSuspended(false);
+}
+
+void ActivationRegions::addActivator(Object* object)
+{
+    if (object != nullptr && std::find(m_activators.begin(), m_activators.end(), object) == m_activators.end())
+        m_activators.emplace_back(object);
+}
+
+void ActivationRegions::removeActivator(Object* object)
+{
+    std::erase_if(m_activators, [object](const Object::Ptr<>& activator){ return !activator || activator.getObj() == object; });
+}
+
+void ActivationRegions::update()
+{
+    m_updateActivatorPositions();
+
+    // collected first so moving objects does not change the cells while iterating
+    std::vector<std::pair<Object*, std::uint64_t>> moved;
+    for (auto iter = m_cells.begin(); iter != m_cells.end();)
+    {
+        std::uint64_t key = iter->first;
+        m_cell& cell = iter->second;
+        float distance = m_getActivatorDistance(key);
+        bool active = cell.active ? distance <= m_suspensionDistance : distance <= m_activationDistance;
+        if (active != cell.active)
+        {
+            cell.active = active;
+            for (std::uint64_t id: cell.objects)
+            {
+                if (Object* object = ObjectManager::getObjectRaw(id))
+                    object->m_setSuspended(!active);
+            }
+        }
+
+        // suspended objects are not updated or simulated so only objects in active cells are checked
+        // destroyed objects in suspended cells are removed once the cell is active again
+        if (cell.active)
+        {
+            for (std::size_t i = 0; i < cell.objects.size();)
+            {
+                Object* object = ObjectManager::getObjectRaw(cell.objects[i]);
+                if (object == nullptr || object->isDestroyQueued())
+                {
+                    m_removeFromCell(cell, i);
+                    continue;
+                }
+                std::uint64_t current = m_getCellKey(object->getGlobalPosition());
+                if (current != key)
+                {
+                    moved.emplace_back(object, current);
+                    m_removeFromCell(cell, i);
+                    continue;
+                }
+                i++;
+            }
+        }
+
+        if (cell.objects.empty())
+            iter = m_cells.erase(iter);
+        else
+            iter++;
+    }
+
+    for (auto& [object, cell]: moved)
+    {
+        m_addToCell(object, cell);
+    }
+}
+
+std::size_t ActivationRegions::getNumberOfCells()
+{
+    return m_cells.size();
+}
+
+std::size_t ActivationRegions::getNumberOfActiveCells()
+{
+    return (std::size_t)std::count_if(m_cells.begin(), m_cells.end(), [](const auto& cell){ return cell.second.active; });
+}
+
+std::size_t ActivationRegions::getNumberOfObjects()
+{
+    return m_locations.size();
+}
+
+std::uint64_t ActivationRegions::m_getCellKey(const Vector2& position)
+{
+    std::int32_t x = (std::int32_t)std::floor(position.x / m_cellSize);
+    std::int32_t y = (std::int32_t)std::floor(position.y / m_cellSize);
+    return ((std::uint64_t)(std::uint32_t)x << 32) | (std::uint32_t)y;
+}
+
+void ActivationRegions::m_updateActivatorPositions()
+{
+    std::erase_if(m_activators, [](const Object::Ptr<>& activator){ return !activator; });
+    m_activatorPositions.clear();
+    for (Object::Ptr<>& activator: m_activators)
+    {
+        m_activatorPositions.emplace_back(activator->getGlobalPosition());
+    }
+    if (m_mainCameraActivator)
+    {
+        if (Camera* camera = CameraManager::getMainCamera())
+            m_activatorPositions.emplace_back(camera->getGlobalPosition());
+    }
+}
+
+float ActivationRegions::m_getActivatorDistance(std::uint64_t cell)
+{
+    float distance = std::numeric_limits<float>::infinity();
+    for (const Vector2& activator: m_activatorPositions)
+    {
+        distance = std::min(distance, m_getDistance(cell, activator));
+    }
+    return distance;
+}
+
+float ActivationRegions::m_getDistance(std::uint64_t cell, const Vector2& position)
+{
+    float left = (std::int32_t)(cell >> 32) * m_cellSize;
+    float bottom = (std::int32_t)(std::uint32_t)cell * m_cellSize;
+    float x = std::max({left - position.x, 0.f, position.x - (left + m_cellSize)});
+    float y = std::max({bottom - position.y, 0.f, position.y - (bottom + m_cellSize)});
+    return std::sqrt(x * x + y * y);
+}
+
+void ActivationRegions::m_addToCell(Object* object, std::uint64_t cell)
+{
+    auto [iter, created] = m_cells.try_emplace(cell);
+    m_cell& data = iter->second;
+    // new cells are only active if they are in the activation distance so objects moving away are suspended right away
+    if (created)
+        data.active = m_getActivatorDistance(cell) <= m_activationDistance;
+    m_locations[object->getID()] = {cell, data.objects.size()};
+    data.objects.emplace_back(object->getID());
+    object->m_setSuspended(!data.active);
+}
+
+void ActivationRegions::m_removeFromCell(m_cell& cell, std::size_t index)
+{
+    m_locations.erase(cell.objects[index]);
+    // swap and pop so the cell stays dense
+    if (index + 1 < cell.objects.size())
+    {
+        cell.objects[index] = cell.objects.back();
+        m_locations[cell.objects[index]].index = index;
+    }
+    cell.objects.pop_back();
+}
@@ -12,6 +12,8 @@
 #include "Physics/CollisionManager.hpp"
 
 #include "ObjectManager.hpp"
+#include "TransformStore.hpp"
+#include "ActivationRegions.hpp"
 #include "UpdateManager.hpp"
 #include "Input.hpp"
 
@@ -21,6 +23,11 @@ Engine& Engine::get()
     return instance;
 }
 
+Engine::Engine()
+{
+    m_initFrameGraph();
+}
+
 void Engine::init(sf::VideoMode mode, const sf::String &title, uint32_t style, sf::State state, const sf::ContextSettings &settings)
 {
     WindowHandler::initRenderWindowSettings(sf::VideoMode::getDesktopMode(), "Game Framework", sf::Style::Default, sf::State::Fullscreen);
@@ -50,7 +57,6 @@ void Engine::init(sf::VideoMode mode, const sf::String &title, uint32_t style, s
 void Engine::preLoop()
 {
     m_deltaClock.start();
-    m_fixedUpdate = 0;
     UpdateManager::Start();
 }
 
@@ -60,7 +66,6 @@ void Engine::preEventHandling()
     // updating the delta time var
     sf::Time deltaTime = m_deltaClock.restart();
     m_deltaTime = deltaTime.asSeconds();
-    m_fixedUpdate += m_deltaTime;
 
     Input::get().UpdateJustStates();
 }
@@ -87,31 +92,14 @@ bool Engine::handleEvent(const sf::Event& event, bool handled)
 
 void Engine::preUserCode()
 {
-    UpdateManager::Update(m_deltaTime);
-    if (m_fixedUpdate >= 0.2)
-    {
-        UpdateManager::FixedUpdate();
-        m_fixedUpdate = 0;
-    }
-    //! Updates all the vars being displayed
-    VarDisplay::Update();
-    //! ------------------------------=-----
-    //! Updates all Terminating Functions
-    TerminatingFunction::UpdateFunctions(m_deltaTime);
-    //* Updates for the terminating functions display
-    TFuncDisplay::Update(); // updates the terminating functions display
-    //! ------------------------------
-
-    //! Do physics before this for consistent physics (in object update)
-    WorldHandler::get().updateWorld(m_deltaTime); // updates the world physics
-    CollisionManager::get()->Update(); // updates the collision callbacks
-    //! Draw after this
-    UpdateManager::LateUpdate(m_deltaTime);
+    m_frameGraph.run();
 }
 
 void Engine::postUserCode()
 {
+    ObjectManager::applyDeferredCommands(); // objects queued from other threads
     ObjectManager::ClearDestroyQueue();
+    TransformStore::updateGlobalTransforms(true); // every drawable reads its interpolated transform from here
     WindowHandler::Display();
 }
 
@@ -127,6 +115,53 @@ float Engine::getDeltaTime() const
     return m_deltaTime;
 }
 
+FrameGraph& Engine::getFrameGraph()
+{
+    return m_frameGraph;
+}
+
+void Engine::m_initFrameGraph()
+{
+    m_frameGraph.clear();
+    // tasks that run user code (updates, events, and callbacks) write everything so they stay in this order
+    m_frameGraph.addTask("ActivationRegions", FrameGraph::None, FrameGraph::All, [](){
+        ActivationRegions::update(); // suspends objects far from the camera before anything is updated
+    });
+    m_frameGraph.addTask("Update", FrameGraph::None, FrameGraph::All, [this](){
+        UpdateManager::Update(m_deltaTime);
+    });
+    m_frameGraph.addTask("TerminatingFunctions", FrameGraph::None, FrameGraph::All, [this](){
+        TerminatingFunction::UpdateFunctions(m_deltaTime);
+    });
+    // the debug displays change TGUI widgets (not thread safe) and the displayed vars can read any object or transform
+    // so they stay on the main thread before the global transforms are updated
+    m_frameGraph.addTask("VarDisplay", FrameGraph::Objects | FrameGraph::Transforms | FrameGraph::Debug, FrameGraph::Graphics | FrameGraph::Debug, [](){
+        VarDisplay::Update(); // updates all the vars being displayed
+    });
+    m_frameGraph.addTask("TFuncDisplay", FrameGraph::Objects | FrameGraph::Transforms | FrameGraph::Debug, FrameGraph::Graphics | FrameGraph::Debug, [](){
+        TFuncDisplay::Update(); // updates the terminating functions display
+    });
+    m_frameGraph.addTask("GlobalTransforms", FrameGraph::None, FrameGraph::Transforms, [](){
+        TransformStore::updateGlobalTransforms(); // so colliders read the global transforms instead of walking their parents
+    });
+    //! Do physics before this for consistent physics (in object update)
+    m_frameGraph.addTask("Physics", FrameGraph::None, FrameGraph::All, [this](){
+        ObjectManager::flushTransformUpdates(); // so colliders are moved before the physics update
+        // fixed updates run once before every physics step so forces applied in them do not depend on the frame rate
+        WorldHandler::get().updateWorld(m_deltaTime, [](){
+            UpdateManager::FixedUpdate();
+            ObjectManager::flushTransformUpdates(); // so colliders moved in the fixed update are moved before the step
+        });
+    });
+    m_frameGraph.addTask("Collisions", FrameGraph::None, FrameGraph::All, [](){
+        CollisionManager::get()->Update(); // updates the collision callbacks
+    });
+    //! Draw after this
+    m_frameGraph.addTask("LateUpdate", FrameGraph::None, FrameGraph::All, [this](){
+        UpdateManager::LateUpdate(m_deltaTime);
+    });
+}
+
 void Engine::tryLoadTheme(std::list<std::string> themes, std::list<std::string> directories)
 {
     for (auto theme: themes)
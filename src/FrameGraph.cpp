@@ -0,0 +1,278 @@
+#include "FrameGraph.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+std::size_t FrameGraph::addTask(const std::string& name, Resources reads, Resources writes, std::function<void()> function, bool mainThread)
+{
+    m_built = false;
+    m_tasks.push_back({name, reads, writes, std::move(function), mainThread, {}, {}, 0, 0, 0});
+    return m_tasks.size() - 1;
+}
+
+std::size_t FrameGraph::insertTask(const std::string& before, const std::string& name, Resources reads, Resources writes, std::function<void()> function, bool mainThread)
+{
+    std::size_t index = getTaskIndex(before);
+    m_built = false;
+    m_tasks.insert(m_tasks.begin() + index, {name, reads, writes, std::move(function), mainThread, {}, {}, 0, 0, 0});
+    return index;
+}
+
+void FrameGraph::removeTask(const std::string& name)
+{
+    std::size_t index = getTaskIndex(name);
+    if (index == m_tasks.size())
+        return;
+    m_built = false;
+    m_tasks.erase(m_tasks.begin() + index);
+}
+
+void FrameGraph::setTaskFunction(const std::string& name, std::function<void()> function)
+{
+    std::size_t index = getTaskIndex(name);
+    if (index == m_tasks.size() || m_running)
+        return;
+    m_tasks[index].function = std::move(function);
+}
+
+void FrameGraph::clear()
+{
+    m_built = false;
+    m_tasks.clear();
+}
+
+std::size_t FrameGraph::getNumberOfTasks() const
+{
+    return m_tasks.size();
+}
+
+std::size_t FrameGraph::getTaskIndex(const std::string& name) const
+{
+    return (std::size_t)(std::find_if(m_tasks.begin(), m_tasks.end(), [&name](const m_task& task){ return task.name == name; }) - m_tasks.begin());
+}
+
+void FrameGraph::run()
+{
+    if (m_tasks.empty() || m_running)
+        return;
+    if (!m_built)
+        m_build();
+
+    m_running = true;
+    m_finished = 0;
+    m_failed = false;
+    m_exception = nullptr;
+    m_ready.clear();
+    for (std::size_t i = 0; i < m_tasks.size(); i++)
+    {
+        m_remaining[i] = m_tasks[i].dependencies.size();
+    }
+
+    m_startTime = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < m_tasks.size(); i++)
+    {
+        if (m_tasks[i].dependencies.empty())
+            m_dispatch(i);
+    }
+
+    std::size_t previousMain = m_tasks.size();
+    std::unique_lock lock(m_lock);
+    while (true)
+    {
+        m_condition.wait(lock, [this](){ return !m_ready.empty() || m_finished == m_tasks.size(); });
+        if (m_ready.empty())
+            break;
+        // main thread tasks are run in the order they were added
+        auto next = std::min_element(m_ready.begin(), m_ready.end());
+        std::size_t task = *next;
+        m_ready.erase(next);
+        lock.unlock();
+
+        m_tasks[task].previousMain = previousMain;
+        previousMain = task;
+        m_execute(task);
+
+        lock.lock();
+    }
+
+    m_frameTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_startTime).count();
+    m_running = false;
+    if (m_exception)
+        std::rethrow_exception(m_exception);
+}
+
+float FrameGraph::getFrameTime() const
+{
+    return m_frameTime;
+}
+
+float FrameGraph::getTaskTime(std::size_t task) const
+{
+    return task < m_tasks.size() ? m_tasks[task].end - m_tasks[task].start : 0.f;
+}
+
+std::vector<std::size_t> FrameGraph::getCriticalPath() const
+{
+    std::vector<std::size_t> path;
+    if (m_tasks.empty() || !m_built)
+        return path;
+
+    std::size_t task = (std::size_t)(std::max_element(m_tasks.begin(), m_tasks.end(), [](const m_task& a, const m_task& b){ return a.end < b.end; }) - m_tasks.begin());
+    // each step goes to a task that finished before the current one started so the path can not be longer than every task
+    while (task < m_tasks.size() && path.size() < m_tasks.size())
+    {
+        path.emplace_back(task);
+        // the task could only start once its last dependency (or the main thread task before it) was done
+        std::size_t previous = m_tasks[task].mainThread ? m_tasks[task].previousMain : m_tasks.size();
+        for (std::size_t dependency: m_tasks[task].dependencies)
+        {
+            if (previous == m_tasks.size() || m_tasks[dependency].end > m_tasks[previous].end)
+                previous = dependency;
+        }
+        task = previous;
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+void FrameGraph::printTimings(std::ostream& stream) const
+{
+    constexpr std::size_t WIDTH = 50;
+
+    std::vector<std::size_t> path = getCriticalPath();
+    std::vector<bool> critical(m_tasks.size(), false);
+    float pathTime = 0;
+    std::size_t nameWidth = 4;
+    std::ios_base::fmtflags flags = stream.flags();
+    std::streamsize precision = stream.precision();
+    stream << std::fixed << std::setprecision(3) << "Critical path: ";
+    for (std::size_t task: path)
+    {
+        critical[task] = true;
+        pathTime += getTaskTime(task);
+        stream << (task == path.front() ? "" : " -> ") << m_tasks[task].name;
+    }
+    stream << "\nFrame: " << m_frameTime * 1000.f << "ms (" << pathTime * 1000.f << "ms spent in critical tasks)\n";
+
+    for (const m_task& task: m_tasks)
+    {
+        nameWidth = std::max(nameWidth, task.name.size());
+    }
+    float scale = m_frameTime > 0 ? WIDTH / m_frameTime : 0.f;
+    for (std::size_t i = 0; i < m_tasks.size(); i++)
+    {
+        const m_task& task = m_tasks[i];
+        std::size_t first = std::min((std::size_t)(task.start * scale), WIDTH - 1);
+        std::size_t last = std::clamp((std::size_t)(task.end * scale), first + 1, WIDTH);
+        stream << (critical[i] ? "* " : "  ") << std::left << std::setw((int)nameWidth) << task.name << std::right
+               << (task.mainThread ? " main " : " pool ")
+               << std::setw(9) << task.start * 1000.f << " - " << std::setw(9) << task.end * 1000.f << "ms |"
+               << std::string(first, ' ') << std::string(last - first, critical[i] ? '#' : '=') << std::string(WIDTH - last, ' ') << "|\n";
+    }
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+void FrameGraph::writeDot(std::ostream& stream) const
+{
+    std::vector<std::size_t> path = getCriticalPath();
+    auto isCritical = [&path](std::size_t task){ return std::find(path.begin(), path.end(), task) != path.end(); };
+
+    std::ios_base::fmtflags flags = stream.flags();
+    std::streamsize precision = stream.precision();
+    stream << std::fixed << std::setprecision(3) << "digraph FrameGraph {\n";
+    for (std::size_t i = 0; i < m_tasks.size(); i++)
+    {
+        const m_task& task = m_tasks[i];
+        stream << "    t" << i << " [label=\"" << task.name << "\\n" << getTaskTime(i) * 1000.f << "ms\""
+               << (task.mainThread ? ", shape=box" : ", shape=ellipse") << (isCritical(i) ? ", color=red" : "") << "];\n";
+    }
+    for (std::size_t i = 0; i < m_tasks.size(); i++)
+    {
+        for (std::size_t dependency: m_tasks[i].dependencies)
+        {
+            stream << "    t" << dependency << " -> t" << i << (isCritical(i) && isCritical(dependency) ? " [color=red]" : "") << ";\n";
+        }
+    }
+    stream << "}\n";
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+void FrameGraph::m_build()
+{
+    std::size_t count = m_tasks.size();
+    // every earlier task each task has to wait for (directly or through another task)
+    std::vector<std::vector<bool>> waitsFor(count, std::vector<bool>(count, false));
+    for (std::size_t i = 0; i < count; i++)
+    {
+        m_task& task = m_tasks[i];
+        task.dependencies.clear();
+        task.dependents.clear();
+        // checked from the latest task so implied dependencies are already known when an earlier task is reached
+        for (std::size_t j = i; j-- > 0;)
+        {
+            const m_task& earlier = m_tasks[j];
+            bool conflict = (earlier.writes & (task.reads | task.writes)) || (earlier.reads & task.writes);
+            if (!conflict || waitsFor[i][j])
+                continue;
+            task.dependencies.emplace_back(j);
+            m_tasks[j].dependents.emplace_back(i);
+            waitsFor[i][j] = true;
+            for (std::size_t k = 0; k < j; k++)
+            {
+                if (waitsFor[j][k])
+                    waitsFor[i][k] = true;
+            }
+        }
+        std::reverse(task.dependencies.begin(), task.dependencies.end());
+    }
+
+    m_remaining = std::make_unique<std::atomic<std::size_t>[]>(count);
+    m_built = true;
+}
+
+void FrameGraph::m_dispatch(std::size_t task)
+{
+    if (m_tasks[task].mainThread)
+    {
+        std::lock_guard lock(m_lock);
+        m_ready.emplace_back(task);
+        m_condition.notify_one();
+    }
+    else
+        ThreadPool::get().detach_task([this, task](){ m_execute(task); });
+}
+
+void FrameGraph::m_execute(std::size_t task)
+{
+    m_task& data = m_tasks[task];
+    data.start = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_startTime).count();
+    if (!m_failed)
+    {
+        try
+        {
+            data.function();
+        }
+        catch (...)
+        {
+            std::lock_guard lock(m_lock);
+            if (!m_exception)
+                m_exception = std::current_exception();
+            m_failed = true;
+        }
+    }
+    data.end = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_startTime).count();
+
+    for (std::size_t dependent: data.dependents)
+    {
+        if (m_remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            m_dispatch(dependent);
+    }
+
+    // notified while locked since the graph can be destroyed as soon as the last task is finished
+    std::lock_guard lock(m_lock);
+    m_finished++;
+    m_condition.notify_one();
+}
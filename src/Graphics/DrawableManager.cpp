@@ -1,6 +1,11 @@
 #include "Graphics/DrawableManager.hpp"
 
+#include <algorithm>
+#include <vector>
+
 std::set<DrawableObject*, _drawableComp> DrawableManager::m_drawables;
+std::unordered_set<DrawableObject*> DrawableManager::m_batched;
+unsigned int DrawableManager::m_batchDepth = 0;
 
 void DrawableManager::draw(sf::RenderTarget* target, sf::ContextSettings contextSettings)
 {
@@ -13,15 +18,42 @@ void DrawableManager::draw(sf::RenderTarget* target, sf::ContextSettings context
 
 void DrawableManager::addDrawable(DrawableObject* DrawableObject)
 {
-    m_drawables.emplace(DrawableObject);
+    if (m_batchDepth > 0)
+        m_batched.emplace(DrawableObject);
+    else
+        m_drawables.emplace(DrawableObject);
 }
 
 void DrawableManager::removeDrawable(DrawableObject* DrawableObject)
 {
+    if (m_batchDepth > 0)
+        m_batched.erase(DrawableObject);
     m_drawables.erase(DrawableObject);
 }
 
+void DrawableManager::beginBatch()
+{
+    m_batchDepth++;
+}
+
+void DrawableManager::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0)
+        return;
+
+    // drawables that were given a drawable parent while batching are already removed
+    std::vector<DrawableObject*> sorted(m_batched.begin(), m_batched.end());
+    m_batched.clear();
+    std::sort(sorted.begin(), sorted.end(), _drawableComp());
+    // inserting in order lets each insert start from where the last one was
+    auto hint = m_drawables.begin();
+    for (DrawableObject* drawable: sorted)
+    {
+        hint = std::next(m_drawables.emplace_hint(hint, drawable));
+    }
+}
+
 size_t DrawableManager::getNumberOfObjects()
 {
-    return m_drawables.size();
+    return m_drawables.size() + m_batched.size();
 }
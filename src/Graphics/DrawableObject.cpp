@@ -21,7 +21,11 @@ DrawableObject::DrawableObject(int layer, DrawStage stage) : m_layer(layer), m_s
 {
     m_onParentSet(&DrawableObject::m_setParent, this);
 
-    DrawableManager::addDrawable(this);
+    // objects loaded from a snapshot already have their parent when constructed
+    if (getParentRaw() != nullptr)
+        m_setParent();
+    else
+        DrawableManager::addDrawable(this);
 }
 
 DrawableObject::~DrawableObject()
@@ -36,9 +40,9 @@ void DrawableObject::setLayer(int layer)
 
     if (m_drawableParent)
     {
-        m_drawableParent->m_drawableChildren.erase(this);
+        m_drawableParent->m_removeDrawableChild(this);
         m_layer = layer;
-        m_drawableParent->m_drawableChildren.emplace(this);
+        m_drawableParent->m_addDrawableChild(this);
     }
     else
     {
@@ -60,9 +64,9 @@ void DrawableObject::setDrawStage(DrawStage stage)
 
     if (m_drawableParent)
     {
-        m_drawableParent->m_drawableChildren.erase(this);
+        m_drawableParent->m_removeDrawableChild(this);
         m_stage = stage;
-        m_drawableParent->m_drawableChildren.emplace(this);
+        m_drawableParent->m_addDrawableChild(this);
     }
     else
     {
@@ -100,7 +104,9 @@ void DrawableObject::m_setParent()
     if (drawableParent != nullptr)
     {
         DrawableManager::removeDrawable(this);
-        drawableParent->m_drawableChildren.emplace(this);
+        if (m_drawableParent != nullptr)
+            m_drawableParent->m_removeDrawableChild(this);
+        drawableParent->m_addDrawableChild(this);
         m_drawableParent = drawableParent;
     }
     else
@@ -114,7 +120,7 @@ void DrawableObject::m_removeParent()
 {
     if (m_drawableParent != nullptr)
     {
-        m_drawableParent->m_drawableChildren.erase(this);
+        m_drawableParent->m_removeDrawableChild(this);
         m_drawableParent = nullptr;
     }
     m_nonDrawableParents = 0;
@@ -123,13 +129,24 @@ void DrawableObject::m_removeParent()
 
 void DrawableObject::m_draw(sf::RenderTarget* target, Transform stateTransform) 
 {
-    if (m_nonDrawableParents > 0)
-        stateTransform += m_getNInterpolatedTransforms(getParentRaw(), m_nonDrawableParents);
-    stateTransform += getInterpolatedTransform();
+    // the engine computes every interpolated transform before drawing so the parents do not have to be walked
+    if (TransformStore::areInterpolatedTransformsValid())
+    {
+        stateTransform = TransformStore::getInterpolatedGlobal(getTransformIndex());
+    }
+    else
+    {
+        if (m_nonDrawableParents > 0)
+            stateTransform += m_getNInterpolatedTransforms(getParentRaw(), m_nonDrawableParents);
+        stateTransform += getInterpolatedTransform();
+    }
     this->Draw(target, stateTransform);
-    for (auto child: m_drawableChildren)
+    if (m_drawableChildren)
     {
-        child->m_draw(target, stateTransform);
+        for (auto child: *m_drawableChildren)
+        {
+            child->m_draw(target, stateTransform);
+        }
     }
     this->LateDraw(target, stateTransform);
 }
@@ -140,3 +157,19 @@ Transform DrawableObject::m_getNInterpolatedTransforms(Object* parent, unsigned
         return Transform{};
     return m_getNInterpolatedTransforms(parent->getParentRaw(), n-1) + parent->getInterpolatedTransform();
 }
+
+void DrawableObject::m_addDrawableChild(DrawableObject* child)
+{
+    if (!m_drawableChildren)
+        m_drawableChildren = std::make_unique<std::set<DrawableObject*, _drawableComp>>();
+    m_drawableChildren->emplace(child);
+}
+
+void DrawableObject::m_removeDrawableChild(DrawableObject* child)
+{
+    if (!m_drawableChildren)
+        return;
+    m_drawableChildren->erase(child);
+    if (m_drawableChildren->empty())
+        m_drawableChildren.reset();
+}
@@ -0,0 +1,467 @@
+#include "LevelStreamer.hpp"
+#include "ThreadPool.hpp"
+#include "Graphics/CameraManager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+
+/// @brief "CGFL" used to check that a file is a level
+constexpr std::uint32_t LEVEL_MAGIC = 0x4C464743;
+/// @brief magic, version, chunk size, and chunk count
+constexpr std::size_t LEVEL_HEADER_SIZE = sizeof(std::uint32_t) * 2 + sizeof(float) + sizeof(std::uint32_t);
+/// @brief x, y, offset, and size
+constexpr std::size_t LEVEL_CHUNK_ENTRY_SIZE = sizeof(std::int32_t) * 2 + sizeof(std::uint64_t) * 2;
+
+LevelStreamer::~LevelStreamer()
+{
+    close();
+}
+
+bool LevelStreamer::writeLevel(const std::string& filePath, float chunkSize, const std::vector<Object*>& roots)
+{
+    if (chunkSize <= 0)
+        return false;
+
+    std::map<std::pair<std::int32_t, std::int32_t>, std::vector<Object::Ptr<>>> grouped;
+    for (Object* root: roots)
+    {
+        Vector2 position = root->getGlobalPosition();
+        grouped[{(std::int32_t)std::floor(position.x / chunkSize), (std::int32_t)std::floor(position.y / chunkSize)}].emplace_back(root);
+    }
+
+    std::vector<std::string> saved;
+    saved.reserve(grouped.size());
+    std::vector<m_chunkData> chunks;
+    for (auto& chunk: grouped)
+    {
+        saved.emplace_back(m_saveObjects(chunk.second));
+        chunks.push_back({chunk.first.first, chunk.first.second, saved.back().data(), saved.back().size()});
+    }
+
+    return m_writeLevel(filePath, chunkSize, chunks);
+}
+
+bool LevelStreamer::open(const std::string& filePath)
+{
+    close();
+    if (!m_file.open(filePath))
+        return false;
+
+    SnapshotReader reader(m_file.getData(), m_file.getSize());
+    std::uint32_t magic = reader.read<std::uint32_t>();
+    std::uint32_t version = reader.read<std::uint32_t>();
+    m_chunkSize = reader.read<float>();
+    std::uint32_t chunkCount = reader.read<std::uint32_t>();
+    if (magic != LEVEL_MAGIC || version != VERSION || !(m_chunkSize > 0) || !reader.isValid() ||
+        LEVEL_HEADER_SIZE + (std::uint64_t)chunkCount * LEVEL_CHUNK_ENTRY_SIZE > m_file.getSize())
+    {
+        m_file.close();
+        return false;
+    }
+
+    m_chunks.resize(chunkCount);
+    m_chunkIndex.reserve(chunkCount);
+    for (std::size_t i = 0; i < m_chunks.size(); i++)
+    {
+        m_chunk& chunk = m_chunks[i];
+        chunk.x = reader.read<std::int32_t>();
+        chunk.y = reader.read<std::int32_t>();
+        chunk.offset = reader.read<std::uint64_t>();
+        chunk.size = reader.read<std::uint64_t>();
+        chunk.load = std::make_unique<SceneSnapshot::IncrementalLoad>();
+        // chunks that point outside of the file are never loaded
+        chunk.invalid = chunk.offset > m_file.getSize() || chunk.size > m_file.getSize() - chunk.offset;
+        m_chunkIndex[m_getKey(chunk.x, chunk.y)] = i;
+    }
+
+    return true;
+}
+
+void LevelStreamer::close()
+{
+    for (std::size_t chunk: m_active)
+    {
+        m_chunk& data = m_chunks[chunk];
+        // the decoded data is not used so it just has to be finished before it is freed
+        if (data.state == m_chunkState::Decoding)
+            data.decoded.wait();
+        else if (data.state == m_chunkState::Instantiating)
+            data.load->cancel();
+        for (Object::Ptr<>& root: data.roots)
+        {
+            if (root && root->getParentRaw() == nullptr)
+                root->destroy();
+        }
+    }
+
+    m_active.clear();
+    m_chunks.clear();
+    m_chunkIndex.clear();
+    m_chunkSize = 0;
+    m_file.close();
+
+    if (m_backing.is_open())
+    {
+        m_backing.close();
+        std::error_code error;
+        std::filesystem::remove(m_backingPath, error);
+    }
+    m_backingPath.clear();
+    m_backingSize = 0;
+}
+
+bool LevelStreamer::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+bool LevelStreamer::save(const std::string& filePath)
+{
+    if (!isOpen())
+        return false;
+
+    // reserved so the data of the saved chunks does not move
+    std::vector<std::string> saved;
+    saved.reserve(m_chunks.size());
+    std::vector<m_chunkData> chunks;
+    chunks.reserve(m_chunks.size());
+    for (const m_chunk& chunk: m_chunks)
+    {
+        std::pair<const char*, std::size_t> data = m_getData(chunk);
+        if (chunk.state == m_chunkState::Loaded)
+        {
+            saved.emplace_back(m_saveObjects(chunk.roots));
+            data = {saved.back().data(), saved.back().size()};
+        }
+        else if (chunk.isSaved)
+        {
+            saved.emplace_back();
+            if (!m_readSaved(m_backingPath, chunk.savedOffset, chunk.savedSize, saved.back()))
+                return false;
+            data = {saved.back().data(), saved.back().size()};
+        }
+        chunks.push_back({chunk.x, chunk.y, data.first, data.second});
+    }
+
+    return m_writeLevel(filePath, m_chunkSize, chunks);
+}
+
+void LevelStreamer::update()
+{
+    if (Camera* camera = CameraManager::getMainCamera())
+        update(camera->getGlobalPosition());
+}
+
+void LevelStreamer::update(const Vector2& center)
+{
+    if (!isOpen())
+        return;
+
+    // unloading chunks that are too far away and checking on the ones being decoded
+    for (std::size_t i = 0; i < m_active.size();)
+    {
+        std::size_t index = m_active[i];
+        m_chunk& chunk = m_chunks[index];
+        chunk.distance = m_getDistance(chunk, center);
+
+        if (chunk.state == m_chunkState::Decoding && chunk.decoded.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            if (chunk.decoded.get())
+            {
+                chunk.state = m_chunkState::Instantiating;
+            }
+            else
+            {
+                chunk.invalid = true;
+                chunk.state = m_chunkState::Unloaded;
+            }
+        }
+
+        // chunks that are still decoding are unloaded once they finish
+        if (chunk.state != m_chunkState::Unloaded && chunk.state != m_chunkState::Decoding && chunk.distance > m_unloadDistance)
+            m_unload(index);
+
+        if (chunk.state == m_chunkState::Unloaded)
+        {
+            m_active[i] = m_active.back();
+            m_active.pop_back();
+            continue;
+        }
+        i++;
+    }
+
+    // only the chunks that could be in the load distance are checked
+    std::int32_t minX = (std::int32_t)std::floor((center.x - m_loadDistance) / m_chunkSize);
+    std::int32_t maxX = (std::int32_t)std::floor((center.x + m_loadDistance) / m_chunkSize);
+    std::int32_t minY = (std::int32_t)std::floor((center.y - m_loadDistance) / m_chunkSize);
+    std::int32_t maxY = (std::int32_t)std::floor((center.y + m_loadDistance) / m_chunkSize);
+    for (std::int32_t x = minX; x <= maxX; x++)
+    {
+        for (std::int32_t y = minY; y <= maxY; y++)
+        {
+            auto chunk = m_chunkIndex.find(m_getKey(x, y));
+            if (chunk == m_chunkIndex.end())
+                continue;
+            m_chunk& data = m_chunks[chunk->second];
+            if (data.state != m_chunkState::Unloaded || data.invalid)
+                continue;
+            data.distance = m_getDistance(data, center);
+            if (data.distance <= m_loadDistance)
+                m_startLoading(chunk->second);
+        }
+    }
+
+    // creating the objects of the closest chunks first
+    std::vector<std::size_t> waiting;
+    for (std::size_t chunk: m_active)
+    {
+        if (m_chunks[chunk].state == m_chunkState::Instantiating)
+            waiting.emplace_back(chunk);
+    }
+    std::sort(waiting.begin(), waiting.end(), [this](std::size_t a, std::size_t b){ return m_chunks[a].distance < m_chunks[b].distance; });
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(m_timeBudget));
+    for (std::size_t index: waiting)
+    {
+        m_chunk& chunk = m_chunks[index];
+        if (!chunk.load->instantiate(deadline))
+            break;
+
+        chunk.state = m_chunkState::Loaded;
+        chunk.roots.assign(chunk.load->getRoots().begin(), chunk.load->getRoots().end());
+        if (std::chrono::steady_clock::now() >= deadline)
+            break;
+    }
+}
+
+void LevelStreamer::setLoadDistance(float distance)
+{
+    m_loadDistance = std::max(distance, 0.f);
+    m_unloadDistance = std::max(m_unloadDistance, m_loadDistance);
+}
+
+float LevelStreamer::getLoadDistance() const
+{
+    return m_loadDistance;
+}
+
+void LevelStreamer::setUnloadDistance(float distance)
+{
+    m_unloadDistance = std::max(distance, m_loadDistance);
+}
+
+float LevelStreamer::getUnloadDistance() const
+{
+    return m_unloadDistance;
+}
+
+void LevelStreamer::setTimeBudget(float seconds)
+{
+    m_timeBudget = std::max(seconds, 0.f);
+}
+
+float LevelStreamer::getTimeBudget() const
+{
+    return m_timeBudget;
+}
+
+float LevelStreamer::getChunkSize() const
+{
+    return m_chunkSize;
+}
+
+std::size_t LevelStreamer::getNumberOfChunks() const
+{
+    return m_chunks.size();
+}
+
+std::size_t LevelStreamer::getNumberOfLoadedChunks() const
+{
+    return (std::size_t)std::count_if(m_active.begin(), m_active.end(), [this](std::size_t chunk){ return m_chunks[chunk].state == m_chunkState::Loaded; });
+}
+
+bool LevelStreamer::isIdle() const
+{
+    return std::all_of(m_active.begin(), m_active.end(), [this](std::size_t chunk){ return m_chunks[chunk].state == m_chunkState::Loaded; });
+}
+
+std::uint64_t LevelStreamer::getBackingFileSize() const
+{
+    return m_backingSize;
+}
+
+bool LevelStreamer::m_writeLevel(const std::string& filePath, float chunkSize, const std::vector<m_chunkData>& chunks)
+{
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    SnapshotWriter writer(file);
+    writer.write<std::uint32_t>(LEVEL_MAGIC);
+    writer.write<std::uint32_t>(VERSION);
+    writer.write<float>(chunkSize);
+    writer.write<std::uint32_t>((std::uint32_t)chunks.size());
+
+    std::uint64_t offset = LEVEL_HEADER_SIZE + chunks.size() * LEVEL_CHUNK_ENTRY_SIZE;
+    for (const m_chunkData& chunk: chunks)
+    {
+        writer.write<std::int32_t>(chunk.x);
+        writer.write<std::int32_t>(chunk.y);
+        writer.write<std::uint64_t>(offset);
+        writer.write<std::uint64_t>(chunk.size);
+        offset += chunk.size;
+    }
+    for (const m_chunkData& chunk: chunks)
+    {
+        writer.writeBytes(chunk.data, chunk.size);
+    }
+    writer.flush();
+
+    return writer.isValid();
+}
+
+std::uint64_t LevelStreamer::m_getKey(std::int32_t x, std::int32_t y)
+{
+    return ((std::uint64_t)(std::uint32_t)x << 32) | (std::uint32_t)y;
+}
+
+std::string LevelStreamer::m_saveObjects(const std::vector<Object::Ptr<>>& roots)
+{
+    std::vector<Object*> objects;
+    objects.reserve(roots.size());
+    for (const Object::Ptr<>& root: roots)
+    {
+        // objects that were given a parent are saved with their new parent
+        if (root && root.getObj()->getParentRaw() == nullptr)
+            objects.emplace_back(root.getObj());
+    }
+
+    std::ostringstream stream(std::ios::binary);
+    SceneSnapshot::save(stream, objects);
+    return std::move(stream).str();
+}
+
+std::pair<const char*, std::size_t> LevelStreamer::m_getData(const m_chunk& chunk) const
+{
+    return {m_file.getData() + chunk.offset, (std::size_t)chunk.size};
+}
+
+bool LevelStreamer::m_writeSaved(m_chunk& chunk, const std::string& data)
+{
+    if (!m_backing.is_open())
+    {
+        std::error_code error;
+        std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+        if (error)
+            return false;
+        // a random name so levels that are open at the same time (even in other processes) do not share a file
+        std::random_device random;
+        m_backingPath = (directory / ("LevelStreamer-" + std::to_string(random()) + std::to_string(random()) + ".tmp")).string();
+        m_backing.open(m_backingPath, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+        m_backingSize = 0;
+        if (!m_backing.is_open())
+            return false;
+    }
+
+    // the file only grows when a chunk is saved bigger than it has been before
+    if (data.size() > chunk.savedCapacity)
+    {
+        chunk.savedOffset = m_backingSize;
+        chunk.savedCapacity = data.size();
+        m_backingSize += data.size();
+    }
+    m_backing.seekp((std::streamoff)chunk.savedOffset);
+    m_backing.write(data.data(), (std::streamsize)data.size());
+    // flushed so the chunk can be read back with another stream from the thread pool
+    m_backing.flush();
+    if (!m_backing)
+    {
+        m_backing.clear();
+        return false;
+    }
+
+    chunk.savedSize = data.size();
+    chunk.isSaved = true;
+    return true;
+}
+
+bool LevelStreamer::m_readSaved(const std::string& path, std::uint64_t offset, std::uint64_t size, std::string& data)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    data.resize((std::size_t)size);
+    file.seekg((std::streamoff)offset);
+    file.read(data.data(), (std::streamsize)size);
+    return (bool)file;
+}
+
+float LevelStreamer::m_getDistance(const m_chunk& chunk, const Vector2& center) const
+{
+    float left = chunk.x * m_chunkSize;
+    float bottom = chunk.y * m_chunkSize;
+    float x = std::max({left - center.x, 0.f, center.x - (left + m_chunkSize)});
+    float y = std::max({bottom - center.y, 0.f, center.y - (bottom + m_chunkSize)});
+    return std::sqrt(x * x + y * y);
+}
+
+void LevelStreamer::m_startLoading(std::size_t chunk)
+{
+    m_chunk& data = m_chunks[chunk];
+    SceneSnapshot::IncrementalLoad* load = data.load.get();
+    if (data.isSaved)
+    {
+        // read on the thread pool as well so the main thread never waits on the file
+        data.decoded = ThreadPool::get().submit_task([load, path = m_backingPath, offset = data.savedOffset, size = data.savedSize]()
+        {
+            std::string saved;
+            return m_readSaved(path, offset, size, saved) && load->decode(saved.data(), saved.size());
+        });
+    }
+    else
+    {
+        std::pair<const char*, std::size_t> source = m_getData(data);
+        // decoding copies the data out of the mapped file which is what pages it in
+        data.decoded = ThreadPool::get().submit_task([load, source](){ return load->decode(source.first, source.second); });
+    }
+    data.state = m_chunkState::Decoding;
+    m_active.emplace_back(chunk);
+}
+
+void LevelStreamer::m_unload(std::size_t chunk)
+{
+    m_chunk& data = m_chunks[chunk];
+    if (data.state == m_chunkState::Instantiating)
+    {
+        // the partly created objects are not saved so the chunk is loaded from its last saved data again
+        data.load->cancel();
+    }
+    else if (data.state == m_chunkState::Loaded)
+    {
+        std::string saved = m_saveObjects(data.roots);
+        std::pair<const char*, std::size_t> original = m_getData(data);
+        // unchanged chunks are loaded from the level file again
+        if (saved.size() == original.second && std::equal(saved.begin(), saved.end(), original.first))
+        {
+            data.isSaved = false;
+        }
+        // the objects are kept if the chunk can not be saved so nothing is lost (it is tried again next update)
+        else if (!m_writeSaved(data, saved))
+        {
+            return;
+        }
+        for (Object::Ptr<>& root: data.roots)
+        {
+            if (root && root->getParentRaw() == nullptr)
+                root->destroy();
+        }
+        data.roots.clear();
+    }
+    data.state = m_chunkState::Unloaded;
+}
@@ -0,0 +1,138 @@
+#include "MappedFile.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& filePath)
+{
+    open(filePath);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& file) noexcept
+{
+    *this = std::move(file);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& file) noexcept
+{
+    if (this == &file)
+        return *this;
+
+    close();
+    m_data = std::exchange(file.m_data, nullptr);
+    m_size = std::exchange(file.m_size, 0);
+#ifdef _WIN32
+    m_file = std::exchange(file.m_file, nullptr);
+    m_mapping = std::exchange(file.m_mapping, nullptr);
+#endif
+    return *this;
+}
+
+bool MappedFile::open(const std::string& filePath)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const char*>(data);
+    m_size = (std::size_t)size.QuadPart;
+#else
+    int file = ::open(filePath.c_str(), O_RDONLY);
+    if (file == -1)
+        return false;
+
+    struct stat info;
+    if (fstat(file, &info) == -1 || info.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    // the mapping keeps the file alive
+    ::close(file);
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const char*>(data);
+    m_size = (std::size_t)info.st_size;
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+    m_file = nullptr;
+    m_mapping = nullptr;
+#else
+    munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool MappedFile::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+const char* MappedFile::getData() const
+{
+    return m_data;
+}
+
+std::size_t MappedFile::getSize() const
+{
+    return m_size;
+}
@@ -1,33 +1,48 @@
 #include "Object.hpp"
 #include "ObjectManager.hpp"
 
-uint64_t Object::m_lastID = 1;
+const Object::m_initialState* Object::m_nextInitialState = nullptr;
 
 Object::Object()
 {
-    m_id = m_lastID++; //! could become an issue if lots of creation and deletion happens
+    m_createdFrame = ObjectManager::m_frame.load(std::memory_order_relaxed);
+    m_transformIndex = TransformStore::add(this);
     ObjectManager::addObject(this);
-}
 
-Object::Object(uint64_t id) : m_id(id) {}
+    if (m_nextInitialState != nullptr)
+    {
+        const m_initialState* state = m_nextInitialState;
+        // cleared first so objects made in the derived constructors are not given the same state
+        m_nextInitialState = nullptr;
+        m_applyInitialState(*state);
+    }
+}
 
-void Object::m_setID(uint64_t id)
+Object::Object(uint64_t id) : m_id(id)
 {
-    m_id = id;
+    m_createdFrame = ObjectManager::m_frame.load(std::memory_order_relaxed);
+    m_transformIndex = TransformStore::add(this);
 }
 
 Object::~Object()
 {
-    // this is not a real object
-    if (m_id == 0)
+    TransformStore::remove(m_transformIndex);
+
+    // this object is not handled by the object manager
+    if (ObjectManager::getObjectRaw(m_id) != this)
         return;
 
     ObjectManager::removeObject(this);
 
+    // children are destroyed first so the parent is always still alive here
     if (m_parent != nullptr)
     {
         m_parent->m_removeChild(this);
     }
+
+    // children are already in the destroy batch
+    if (m_destroyBatched)
+        return;
     
     auto child = m_children.begin();
     while (child != m_children.end())
@@ -35,7 +50,7 @@ Object::~Object()
         auto temp = child++;
         (*temp)->onDestroy.invoke();
         (*temp)->m_onDestroy.invoke();
-        delete(*temp);
+        ObjectManager::releaseObject(*temp);
     }
     m_children.clear();
 }
@@ -53,16 +68,47 @@ void Object::m_invokeDestroyEvents()
 {
     for (auto child: m_children)
     {
+        child->m_destroyQueued = true; // children are destroyed with this object
         child->m_invokeDestroyEvents();
     }
     m_enabled = false; // dont want the event to be called
+    m_enabledInHierarchy = false;
     m_onDestroyQueued.invoke();
     onDestroyQueued.invoke();
 }
 
+void* Object::operator new(std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* Object::operator new(std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void Object::operator delete(void* memory) noexcept
+{
+    if (!ObjectManager::m_deferFree(memory))
+        ::operator delete(memory);
+}
+
+void Object::operator delete(void* memory, std::align_val_t alignment) noexcept
+{
+    // over aligned objects are rare so they are not kept for the batch
+    ::operator delete(memory, alignment);
+}
+
 void Object::setEnabled(bool enabled)
 {
     m_enabled = enabled;
+    bool enabledInHierarchy = m_calculateEnabledInHierarchy();
+    if (enabledInHierarchy != m_enabledInHierarchy)
+    {
+        m_enabledInHierarchy = enabledInHierarchy;
+        m_propagateEnabled();
+    }
+
     if (m_enabled)
     {
         m_onEnabled.invoke();
@@ -79,13 +125,53 @@ void Object::setEnabled(bool enabled)
 
 bool Object::isEnabled() const
 {
-    if (m_parent)
-        return m_enabled && m_parent->isEnabled();
+    return m_enabledInHierarchy;
+}
+
+bool Object::isSuspended() const
+{
+    return m_suspended;
+}
+
+void Object::m_propagateEnabled()
+{
+    for (auto child: m_children)
+    {
+        bool enabledInHierarchy = child->m_calculateEnabledInHierarchy();
+        if (enabledInHierarchy == child->m_enabledInHierarchy)
+            continue;
+        child->m_enabledInHierarchy = enabledInHierarchy;
+        if (enabledInHierarchy)
+            child->m_onEnabled.invoke();
+        else
+            child->m_onDisabled.invoke();
+        child->m_propagateEnabled();
+    }
+}
+
+bool Object::m_calculateEnabledInHierarchy() const
+{
+    return m_enabled && !m_suspended && (m_parent == nullptr || m_parent->m_enabledInHierarchy);
+}
+
+void Object::m_setSuspended(bool suspended)
+{
+    if (suspended == m_suspended)
+        return;
+    m_suspended = suspended;
+
+    bool enabledInHierarchy = m_calculateEnabledInHierarchy();
+    if (enabledInHierarchy == m_enabledInHierarchy)
+        return;
+    m_enabledInHierarchy = enabledInHierarchy;
+    if (m_enabledInHierarchy)
+        m_onEnabled.invoke();
     else
-        return m_enabled;
+        m_onDisabled.invoke();
+    m_propagateEnabled();
 }
 
-unsigned long int Object::getID() const
+uint64_t Object::getID() const
 {
     return m_id;
 }
@@ -118,9 +204,22 @@ void Object::setParent(Object* parent)
     {
         parent->m_addChild(this);
     }
+    TransformStore::setParent(m_transformIndex, m_parent != nullptr ? m_parent->m_transformIndex : TransformStore::NO_PARENT);
+
+    bool enabledInHierarchy = m_calculateEnabledInHierarchy();
+    if (enabledInHierarchy != m_enabledInHierarchy)
+    {
+        m_enabledInHierarchy = enabledInHierarchy;
+        if (m_enabledInHierarchy)
+            m_onEnabled.invoke();
+        else
+            m_onDisabled.invoke();
+        m_propagateEnabled();
+    }
 
     if (lastParent != m_parent)
     {
+        m_setGlobalTransformDirty();
         m_onParentSet.invoke();
         onParentSet.invoke();
     }
@@ -156,7 +255,7 @@ Vector2 Object::getLocalPoint(const Vector2& point) const
         return Object::getGlobalTransform().getLocalPoint(point);
     }
     else
-        return m_transform.getLocalPoint(point);
+        return TransformStore::get(m_transformIndex).getLocalPoint(point);
 }
 
 Vector2 Object::getGlobalPoint(const Vector2& point) const
@@ -166,7 +265,7 @@ Vector2 Object::getGlobalPoint(const Vector2& point) const
         return Object::getGlobalTransform().getGlobalPoint(point);
     }
     else
-        return m_transform.getGlobalPoint(point);
+        return TransformStore::get(m_transformIndex).getGlobalPoint(point);
 }
 
 Vector2 Object::getGlobalVector(const Vector2& vec) const
@@ -177,7 +276,7 @@ Vector2 Object::getGlobalVector(const Vector2& vec) const
         return Vector2{rot.cos * vec.x - rot.sin * vec.y, rot.sin * vec.x + rot.cos * vec.y};
     }
     else
-        return m_transform.getGlobalVector(vec);
+        return TransformStore::get(m_transformIndex).getGlobalVector(vec);
 }
 
 Vector2 Object::getLocalVector(const Vector2& vec) const
@@ -188,23 +287,22 @@ Vector2 Object::getLocalVector(const Vector2& vec) const
         return Vector2{rot.cos * vec.x + rot.sin * vec.y, -rot.sin * vec.x + rot.cos * vec.y};
     }
     else
-        return m_transform.getLocalVector(vec);
+        return TransformStore::get(m_transformIndex).getLocalVector(vec);
 }
 
 void Object::rotateAround(const Vector2& center, Rotation rot)
 {
-    Vector2 posChange(Vector2::rotateAround({m_transform.position}, {center}, rot) - m_transform.position);
-    m_transform.position += posChange;
-    m_onTransformUpdated.invoke();
-    onTransformUpdated.invoke();
+    Vector2 position = TransformStore::getPosition(m_transformIndex);
+    TransformStore::setPosition(m_transformIndex, Vector2::rotateAround(position, center, rot));
+    m_setGlobalTransformDirty();
+    m_transformUpdated();
 }
 
 void Object::setPosition(const Vector2& position)
 {   
-    // Vector2 posChange(position - m_transform.position);
-    m_transform.position = position;
-    m_onTransformUpdated.invoke();
-    onTransformUpdated.invoke();
+    TransformStore::setPosition(m_transformIndex, position);
+    m_setGlobalTransformDirty();
+    m_transformUpdated();
 }
 
 void Object::setPosition(float x, float y)
@@ -214,44 +312,38 @@ void Object::setPosition(float x, float y)
 
 Vector2 Object::getPosition() const
 {   
-    return m_transform.position;
+    return TransformStore::getPosition(m_transformIndex);
 }
 
 void Object::setRotation(Rotation rotation)
 {
-    // Rotation rotChange = rotation - m_transform.rotation;
-    m_transform.rotation = rotation;
-    m_onTransformUpdated.invoke();
-    onTransformUpdated.invoke();
+    TransformStore::setRotation(m_transformIndex, rotation);
+    m_setGlobalTransformDirty();
+    m_transformUpdated();
 }
 
 Rotation Object::getRotation() const
 {
-    return m_transform.rotation;
+    return TransformStore::getRotation(m_transformIndex);
 }
 
 void Object::setTransform(const Transform& transform)
 {
-    // disable events so they are only called once
-    m_onTransformUpdated.setEnabled(false);
-    onTransformUpdated.setEnabled(false);
-    Object::setPosition(transform.position);
-    // enable events so they are call on set rotation
-    m_onTransformUpdated.setEnabled(true);
-    onTransformUpdated.setEnabled(true);
-    Object::setRotation(transform.rotation);
+    TransformStore::set(m_transformIndex, transform);
+    m_setGlobalTransformDirty();
+    m_transformUpdated();
 }
 
-const Transform& Object::getTransform() const
+const Transform Object::getTransform() const
 {
-    return m_transform;
+    return TransformStore::get(m_transformIndex);
 }
 
 void Object::move(const Vector2& move)
 {
-    m_transform.position += move;
-    m_onTransformUpdated.invoke();
-    onTransformUpdated.invoke();
+    TransformStore::setPosition(m_transformIndex, TransformStore::getPosition(m_transformIndex) + move);
+    m_setGlobalTransformDirty();
+    m_transformUpdated();
 }
 
 void Object::move(float x, float y)
@@ -261,9 +353,9 @@ void Object::move(float x, float y)
 
 void Object::rotate(Rotation rot)
 {
-    m_transform.rotation = m_transform.rotation + rot;
-    m_onTransformUpdated.invoke();
-    onTransformUpdated.invoke();
+    TransformStore::setRotation(m_transformIndex, TransformStore::getRotation(m_transformIndex) + rot);
+    m_setGlobalTransformDirty();
+    m_transformUpdated();
 }
 
 void Object::setGlobalPosition(const Vector2& position)
@@ -282,7 +374,8 @@ Vector2 Object::getGlobalPosition() const
 {
     if (m_parent)
     {
-        return (Vector2::rotateAround(Object::getPosition(), {0,0}, m_parent->getGlobalRotation()) + m_parent->getGlobalPosition());
+        m_updateGlobalTransform();
+        return m_globalTransform.position;
     }
     return Object::getPosition();
 }
@@ -303,7 +396,8 @@ Rotation Object::getGlobalRotation() const
 {
     if (m_parent)
     {
-        return Object::getRotation() + m_parent->getGlobalRotation();
+        m_updateGlobalTransform();
+        return m_globalTransform.rotation;
     }
     return Object::getRotation();
 }
@@ -312,14 +406,7 @@ void Object::setGlobalTransform(const Transform& transform)
 {
     if (m_parent)
     {
-        // disable events so they are only called once
-        m_onTransformUpdated.setEnabled(false);
-        onTransformUpdated.setEnabled(false);
-        Object::setGlobalPosition(transform.position);
-        // enable events so they are call on set rotation
-        m_onTransformUpdated.setEnabled(true);
-        onTransformUpdated.setEnabled(true);
-        Object::setGlobalRotation(transform.rotation);
+        Object::setTransform(Transform(transform.position - m_parent->getGlobalPosition(), transform.rotation - m_parent->getGlobalRotation()));
     }
     else
     {
@@ -331,12 +418,91 @@ const Transform Object::getGlobalTransform() const
 {
     if (m_parent)
     {
-        return Transform(Object::getGlobalPosition(), Object::getGlobalRotation());
+        m_updateGlobalTransform();
+        return m_globalTransform;
+    }
+    else
+    {
+        return TransformStore::get(m_transformIndex);
+    }
+}
+
+std::uint32_t Object::getTransformIndex() const
+{
+    return m_transformIndex;
+}
+
+void Object::m_transformUpdated()
+{
+    // objects not handled by the object manager can not be queued
+    if (ObjectManager::isDeferringTransformUpdates() && (std::uint32_t)m_id != 0)
+    {
+        ObjectManager::addToTransformUpdateQueue(this);
+        return;
+    }
+    m_onTransformUpdated.invoke();
+    onTransformUpdated.invoke();
+}
+
+void Object::m_applyInitialState(const m_initialState& state)
+{
+    TransformStore::set(m_transformIndex, state.transform);
+    if (state.parent != nullptr)
+    {
+        m_parent = state.parent;
+        m_parent->m_addChild(this);
+        TransformStore::setParent(m_transformIndex, m_parent->m_transformIndex);
+        m_enabledInHierarchy = m_calculateEnabledInHierarchy();
+    }
+    setUserType(state.userType);
+}
+
+ObjectTypeInfo* Object::m_resolveTypeInfo() const
+{
+    // objects are only created on the main thread so once the frame has changed the constructors are done
+    if (m_createdFrame == ObjectManager::m_frame.load(std::memory_order_relaxed))
+        return nullptr;
+    ObjectTypeInfo* typeInfo = &ObjectTypeInfo::get(typeid(*this));
+    m_typeInfo.store(typeInfo, std::memory_order_relaxed);
+    return typeInfo;
+}
+
+void Object::m_setGlobalTransformDirty()
+{
+    if (m_globalTransformDirty)
+        return;
+    m_globalTransformDirty = true;
+    for (auto child: m_children)
+    {
+        child->m_setGlobalTransformDirty();
+    }
+}
+
+void Object::m_updateGlobalTransform() const
+{
+    if (!m_globalTransformDirty)
+        return;
+    // nothing has moved since every global transform was computed so the parents do not have to be recalculated
+    if (TransformStore::areGlobalTransformsValid())
+    {
+        // dirty parents are also updated so the children of a dirty object are always dirty
+        for (const Object* object = this; object != nullptr && object->m_globalTransformDirty; object = object->m_parent)
+        {
+            object->m_globalTransform = TransformStore::getGlobal(object->m_transformIndex);
+            object->m_globalTransformDirty = false;
+        }
+        return;
+    }
+    if (m_parent)
+    {
+        m_parent->m_updateGlobalTransform();
+        m_globalTransform = m_parent->m_globalTransform + TransformStore::get(m_transformIndex);
     }
     else
     {
-        return m_transform;
+        m_globalTransform = TransformStore::get(m_transformIndex);
     }
+    m_globalTransformDirty = false;
 }
 
 void Object::m_addChild(Object* object)
@@ -351,11 +517,16 @@ void Object::m_removeChild(Object* object)
 
 Transform Object::getInterpolatedTransform() const
 {
-    return m_transform;
+    return TransformStore::get(m_transformIndex);
 }
 
 void Object::setUserType(uint64_t type)
 {   
+    if (type == m_userType)
+        return;
+    // objects not handled by the object manager are not tracked
+    if (ObjectManager::getObjectRaw(m_id) == this)
+        ObjectManager::setUserType(this, type);
     m_userType = type;
 }
 
@@ -1,19 +1,32 @@
 #include "ObjectManager.hpp"
+#include "ThreadPool.hpp"
 
-_objectCompare ObjectManager::m_compClass;
-std::unordered_set<Object*> ObjectManager::m_objects;
+#include <algorithm>
 
-std::list<Object*> ObjectManager::m_destroyQueue0;
-std::list<Object*> ObjectManager::m_destroyQueue1;
+std::vector<Object*> ObjectManager::m_objects;
+std::vector<ObjectManager::m_objectSlot> ObjectManager::m_slots{ObjectManager::m_objectSlot{nullptr, 0}};
+std::vector<std::uint32_t> ObjectManager::m_freeSlots;
+std::unordered_map<uint64_t, std::vector<Object*>> ObjectManager::m_userTypes;
+std::atomic<std::uint32_t> ObjectManager::m_nextSlot{1};
+uint64_t ObjectManager::m_reservedID = 0;
+std::atomic<std::uint32_t> ObjectManager::m_frame{0};
+std::atomic<ObjectManager::m_deferredCommand*> ObjectManager::m_deferredCommands{nullptr};
+
+std::vector<Object*> ObjectManager::m_destroyQueue0;
+std::vector<Object*> ObjectManager::m_destroyQueue1;
 bool ObjectManager::m_nextQueue = false;
+std::vector<Object*> ObjectManager::m_destroyBatch;
+
+bool ObjectManager::m_deferTransformUpdates = false;
+std::vector<uint64_t> ObjectManager::m_transformUpdateQueue;
+uint64_t ObjectManager::m_collapsedTransformUpdates = 0;
+std::mutex ObjectManager::m_transformUpdateQueueLock;
+bool ObjectManager::m_deferHeapFree = false;
+std::vector<void*> ObjectManager::m_heapMemory;
 
 Object::Ptr<> ObjectManager::getObject(uint64_t id)
 {
-    m_compClass.setID(id);
-    std::unordered_set<Object*>::iterator obj = m_objects.find((Object*)&m_compClass);
-    m_compClass.setID(0);
-
-    return Object::Ptr(obj == m_objects.end() ? nullptr : *obj);
+    return Object::Ptr(getObjectRaw(id));
 }
 
 size_t ObjectManager::getNumberOfObjects()
@@ -21,35 +34,254 @@ size_t ObjectManager::getNumberOfObjects()
     return m_objects.size();
 }
 
+void ObjectManager::reserve(std::size_t count)
+{
+    // growing at least geometrically so reserving often (i.e. when streaming) does not reallocate every time
+    std::size_t objects = m_objects.size() + count;
+    if (objects > m_objects.capacity())
+        m_objects.reserve(std::max(objects, m_objects.capacity() * 2));
+    if (count <= m_freeSlots.size())
+        return;
+    std::size_t slots = m_slots.size() + count - m_freeSlots.size();
+    if (slots > m_slots.capacity())
+        m_slots.reserve(std::max(slots, m_slots.capacity() * 2));
+}
+
+const std::vector<Object*>& ObjectManager::getObjects()
+{
+    return m_objects;
+}
+
+const std::vector<Object*>& ObjectManager::getObjectsOfUserType(uint64_t type)
+{
+    static const std::vector<Object*> empty;
+    auto bucket = m_userTypes.find(type);
+    return bucket == m_userTypes.end() ? empty : bucket->second;
+}
+
+std::size_t ObjectManager::getNumberOfObjectsOfUserType(uint64_t type)
+{
+    auto bucket = m_userTypes.find(type);
+    return bucket == m_userTypes.end() ? 0 : bucket->second.size();
+}
+
 void ObjectManager::ClearDestroyQueue()
 {
-    std::list<Object*>& list = m_nextQueue ? m_destroyQueue1 : m_destroyQueue0;
-    for (std::list<Object*>::iterator obj = list.begin(); obj != list.end(); obj++)
+    std::vector<Object*>& queue = m_nextQueue ? m_destroyQueue1 : m_destroyQueue0;
+    m_collectDestroyBatch(queue);
+    queue.clear();
+
+    // every object is still alive while the events are called
+    for (Object* object: m_destroyBatch)
+    {
+        object->onDestroy.invoke();
+        object->m_onDestroy.invoke();
+    }
+
+    // in reverse so children are destructed before their parents (the parent is still alive in the child destructor)
+    // destructors remove the objects from the managers so they are called here, only the heap memory is freed later
+    m_deferHeapFree = true;
+    for (std::size_t i = m_destroyBatch.size(); i-- > 0;)
+    {
+        releaseObject(m_destroyBatch[i]);
+    }
+    m_deferHeapFree = false;
+    m_destroyBatch.clear();
+
+    if (m_heapMemory.size() >= m_parallelFreeThreshold)
+    {
+        ThreadPool::get().detach_task([memory = std::move(m_heapMemory)](){ m_freeMemory(memory); });
+    }
+    else
     {
-        (*obj)->onDestroy.invoke();
-        (*obj)->m_onDestroy.invoke();
-        delete(*obj);
+        m_freeMemory(m_heapMemory);
     }
-    list.clear();
+    m_heapMemory.clear();
 
     m_nextQueue = !m_nextQueue;
+    m_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ObjectManager::m_deferFree(void* memory)
+{
+    if (!m_deferHeapFree)
+        return false;
+    m_heapMemory.emplace_back(memory);
+    return true;
+}
+
+void ObjectManager::m_freeMemory(const std::vector<void*>& memory)
+{
+    for (void* ptr: memory)
+    {
+        ::operator delete(ptr);
+    }
+}
+
+void ObjectManager::m_collectDestroyBatch(const std::vector<Object*>& roots)
+{
+    for (Object* object: roots)
+    {
+        // the subtree will be collected with the queued parent
+        if (object->m_parent != nullptr && object->m_parent->m_destroyQueued)
+            continue;
+        object->m_destroyBatched = true;
+        m_destroyBatch.emplace_back(object);
+    }
+
+    // breadth first so parents are always before their children
+    for (std::size_t i = 0; i < m_destroyBatch.size(); i++)
+    {
+        for (Object* child: m_destroyBatch[i]->m_children)
+        {
+            child->m_destroyBatched = true;
+            m_destroyBatch.emplace_back(child);
+        }
+    }
 }
 
 Object::Ptr<> ObjectManager::addObject(Object* object)
 {
-    m_objects.insert({object});
+    std::uint32_t slot;
+    if (m_reservedID != 0)
+    {
+        slot = (std::uint32_t)m_reservedID;
+        m_reservedID = 0;
+    }
+    else if (m_freeSlots.empty())
+    {
+        slot = m_nextSlot.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    // slots can be reserved from other threads so there may be a gap
+    if (slot >= m_slots.size())
+        m_slots.resize(slot + 1);
+    m_slots[slot].object = object;
+    object->m_id = ((std::uint64_t)m_slots[slot].generation << 32) | slot;
+
+    object->m_index = (std::uint32_t)m_objects.size();
+    m_objects.emplace_back(object);
     return object->getPtr();
 }
 
 void ObjectManager::removeObject(Object* object)
 {
-    m_objects.erase(object);
+    setUserType(object, 0);
+
+    std::uint32_t slotIndex = (std::uint32_t)object->m_id;
+    m_objectSlot& slot = m_slots[slotIndex];
+    slot.object = nullptr;
+    // invalidates every Ptr and id of this object without having to notify them
+    if (++slot.generation == 0)
+        slot.generation = 1;
+    m_freeSlots.emplace_back(slotIndex);
+
+    // swap and pop so the objects stay dense
+    Object* last = m_objects.back();
+    m_objects[object->m_index] = last;
+    last->m_index = object->m_index;
+    m_objects.pop_back();
+}
+
+void ObjectManager::destroyDeferred(uint64_t id)
+{
+    m_deferredCommand* command = new m_deferredCommand();
+    command->id = id;
+    m_pushCommand(command);
+}
+
+void ObjectManager::applyDeferredCommands()
+{
+    // taking every command at once so other threads can keep queuing while these are applied
+    m_deferredCommand* command = m_deferredCommands.exchange(nullptr, std::memory_order_acquire);
+
+    // reversing so commands are applied in the order they were queued
+    m_deferredCommand* ordered = nullptr;
+    while (command != nullptr)
+    {
+        m_deferredCommand* next = command->next;
+        command->next = ordered;
+        ordered = command;
+        command = next;
+    }
+
+    while (ordered != nullptr)
+    {
+        if (ordered->create)
+        {
+            m_reservedID = ordered->id;
+            ordered->create();
+            m_reservedID = 0;
+        }
+        else if (Object* object = getObjectRaw(ordered->id))
+        {
+            object->destroy();
+        }
+
+        m_deferredCommand* next = ordered->next;
+        delete ordered;
+        ordered = next;
+    }
+}
+
+uint64_t ObjectManager::m_reserveID()
+{
+    // new slots always start at generation 1
+    return ((std::uint64_t)1 << 32) | m_nextSlot.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ObjectManager::m_pushCommand(m_deferredCommand* command)
+{
+    command->next = m_deferredCommands.load(std::memory_order_relaxed);
+    while (!m_deferredCommands.compare_exchange_weak(command->next, command, std::memory_order_release, std::memory_order_relaxed));
 }
 
 void ObjectManager::addToDestroyQueue(Object* object)
 {
-    std::list<Object*>& list = m_nextQueue ? m_destroyQueue0 : m_destroyQueue1;
-    list.emplace_back(object);
+    std::vector<Object*>& queue = m_nextQueue ? m_destroyQueue0 : m_destroyQueue1;
+    queue.emplace_back(object);
+}
+
+void ObjectManager::setUserType(Object* object, uint64_t type)
+{
+    if (object->m_userType != 0)
+    {
+        // swap and pop so the bucket stays dense, empty buckets are kept since the type is likely to be used again
+        std::vector<Object*>& bucket = m_userTypes[object->m_userType];
+        Object* last = bucket.back();
+        bucket[object->m_userTypeIndex] = last;
+        last->m_userTypeIndex = object->m_userTypeIndex;
+        bucket.pop_back();
+    }
+
+    if (type != 0)
+    {
+        std::vector<Object*>& bucket = m_userTypes[type];
+        object->m_userTypeIndex = (std::uint32_t)bucket.size();
+        bucket.emplace_back(object);
+    }
+}
+
+void ObjectManager::releaseObject(Object* object)
+{
+    ObjectPoolBase* pool = object->m_pool;
+    // the type changes while destructing so casts use dynamic_cast and the type is not resolved again
+    object->m_typeInfo.store(nullptr, std::memory_order_relaxed);
+    object->m_createdFrame = m_frame.load(std::memory_order_relaxed);
+    // delete so any operator delete of the type is used
+    if (pool == nullptr)
+    {
+        delete(object);
+        return;
+    }
+
+    void* memory = dynamic_cast<void*>(object); // the start of the most derived object
+    object->~Object();
+    pool->deallocate(memory);
 }
 
 void ObjectManager::destroyAllObjects()
@@ -63,5 +295,55 @@ void ObjectManager::destroyAllObjects()
     }
     ClearDestroyQueue(); 
     ClearDestroyQueue(); // clearing twice for both queues
-    Object::m_lastID = 1;
+}
+
+void ObjectManager::setDeferTransformUpdates(bool defer)
+{
+    m_deferTransformUpdates = defer;
+    if (!m_deferTransformUpdates)
+        flushTransformUpdates();
+}
+
+bool ObjectManager::isDeferringTransformUpdates()
+{
+    return m_deferTransformUpdates;
+}
+
+void ObjectManager::flushTransformUpdates()
+{
+    // objects moved by the events are handled in the next flush
+    std::size_t size = m_transformUpdateQueue.size();
+    for (std::size_t i = 0; i < size; i++)
+    {
+        Object* object = getObjectRaw(m_transformUpdateQueue[i]);
+        // object was destroyed after it was moved
+        if (object == nullptr)
+            continue;
+        object->m_transformUpdateQueued = false;
+        object->m_onTransformUpdated.invoke();
+        object->onTransformUpdated.invoke();
+    }
+    m_transformUpdateQueue.erase(m_transformUpdateQueue.begin(), m_transformUpdateQueue.begin() + size);
+}
+
+uint64_t ObjectManager::getCollapsedTransformUpdates()
+{
+    return m_collapsedTransformUpdates;
+}
+
+void ObjectManager::resetCollapsedTransformUpdates()
+{
+    m_collapsedTransformUpdates = 0;
+}
+
+void ObjectManager::addToTransformUpdateQueue(Object* object)
+{
+    std::lock_guard lock(m_transformUpdateQueueLock);
+    if (object->m_transformUpdateQueued)
+    {
+        m_collapsedTransformUpdates++;
+        return;
+    }
+    object->m_transformUpdateQueued = true;
+    m_transformUpdateQueue.emplace_back(object->m_id);
 }
@@ -0,0 +1,33 @@
+#include "ObjectTypeInfo.hpp"
+
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+std::atomic<std::size_t> ObjectTypeInfo::m_nextTypeID = 0;
+
+ObjectTypeInfo::ObjectTypeInfo(const std::type_info& type) : m_type(type)
+{
+    for (auto& offset: m_offsets)
+    {
+        offset.store(UNKNOWN, std::memory_order_relaxed);
+    }
+}
+
+ObjectTypeInfo& ObjectTypeInfo::get(const std::type_info& type)
+{
+    static std::mutex mutex;
+    static std::unordered_map<std::type_index, std::unique_ptr<ObjectTypeInfo>> infos;
+
+    std::lock_guard lock(mutex);
+    std::unique_ptr<ObjectTypeInfo>& info = infos[std::type_index(type)];
+    if (!info)
+        info.reset(new ObjectTypeInfo(type));
+    return *info;
+}
+
+const std::type_info& ObjectTypeInfo::getType() const
+{
+    return m_type;
+}
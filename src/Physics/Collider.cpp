@@ -1,6 +1,11 @@
 #include "Physics/Collider.hpp"
 #include "Physics/CollisionManager.hpp"
 #include "Physics/WorldHandler.hpp"
+#include "SnapshotStream.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 #ifdef DEBUG
 #define CHECK_IF_IN_PHYSICS_UPDATE(note) assert(WorldHandler::get().isInPhysicsUpdate() == 0 && note)
@@ -25,8 +30,10 @@ Collider::Collider(WorldHandler& world)
     // initializing the body in box2d
     b2BodyDef bodyDef = b2DefaultBodyDef();
     bodyDef.type = b2_dynamicBody;
-    bodyDef.position = (b2Vec2)Object::getPosition();
-    bodyDef.rotation = (b2Rot)Object::getRotation();
+    // objects can be created with a parent (i.e. when loaded from a snapshot) so the global transform is used
+    Transform transform = Object::getGlobalTransform();
+    bodyDef.position = (b2Vec2)transform.position;
+    bodyDef.rotation = (b2Rot)transform.rotation;
     m_body = b2CreateBody(world.getWorld(), &bodyDef);
     b2Body_SetUserData(m_body, (void*)this);
 }
@@ -111,8 +118,9 @@ void Collider::m_updatePhysicsState()
 
 void Collider::m_updateTransform()
 {
-    // This could lead to slow downs since we are using lots of trig functions here
-    b2Body_SetTransform(m_body, (b2Vec2)Object::getGlobalPosition(), (b2Rot)Object::getGlobalRotation() /*using atan2 then cos and sin*/); 
+    // the global transform is read from the TransformStore if it was computed since the last change
+    Transform transform = Object::getGlobalTransform();
+    b2Body_SetTransform(m_body, (b2Vec2)transform.position, (b2Rot)transform.rotation); 
 }
 
 void Collider::m_update(b2Transform* transform)
@@ -373,3 +381,195 @@ Transform Collider::getInterpolatedTransform() const
     // TODO make it so that you are able to choose which world handler you get the interpolation time from
     return Transform{Object::getPosition() + WorldHandler::get().getInterpolationTime() * b2Body_GetLinearVelocity(m_body), Object::getRotation() + b2Body_GetAngularVelocity(m_body) * WorldHandler::get().getInterpolationTime()};
 }
+
+void Collider::writeColliderSnapshot(SnapshotWriter& writer) const
+{
+    writer.write<std::int32_t>((std::int32_t)b2Body_GetType(m_body));
+    writer.write<std::uint8_t>(m_enabled);
+    writer.write<std::uint8_t>(b2Body_IsAwake(m_body));
+    writer.write<std::uint8_t>(b2Body_IsSleepEnabled(m_body));
+    writer.write<std::uint8_t>(b2Body_IsBullet(m_body));
+    writer.write<std::uint8_t>(b2Body_IsFixedRotation(m_body));
+    writer.write<b2Vec2>(b2Body_GetLinearVelocity(m_body));
+    writer.write<float>(b2Body_GetAngularVelocity(m_body));
+    writer.write<float>(b2Body_GetLinearDamping(m_body));
+    writer.write<float>(b2Body_GetAngularDamping(m_body));
+    writer.write<float>(b2Body_GetGravityScale(m_body));
+    writer.write<float>(b2Body_GetSleepThreshold(m_body));
+
+    std::vector<b2ShapeId> shapes(b2Body_GetShapeCount(m_body));
+    b2Body_GetShapes(m_body, shapes.data(), (int)shapes.size());
+    // chain segments are owned by chains which are not supported yet
+    shapes.erase(std::remove_if(shapes.begin(), shapes.end(), [](b2ShapeId shape){ return b2Shape_GetType(shape) == b2_chainSegmentShape; }), shapes.end());
+
+    writer.write<std::int32_t>((std::int32_t)shapes.size());
+    for (b2ShapeId shape: shapes)
+    {
+        b2ShapeType type = b2Shape_GetType(shape);
+        writer.write<std::int32_t>((std::int32_t)type);
+        writer.write<float>(b2Shape_GetDensity(shape));
+        writer.write<float>(b2Shape_GetFriction(shape));
+        writer.write<float>(b2Shape_GetRestitution(shape));
+        writer.write<b2Filter>(b2Shape_GetFilter(shape));
+        writer.write<std::uint8_t>(b2Shape_IsSensor(shape));
+        writer.write<std::uint8_t>(b2Shape_AreSensorEventsEnabled(shape));
+        writer.write<std::uint8_t>(b2Shape_AreContactEventsEnabled(shape));
+        writer.write<std::uint8_t>(b2Shape_ArePreSolveEventsEnabled(shape));
+        switch (type)
+        {
+        case b2_circleShape:
+            writer.write<b2Circle>(b2Shape_GetCircle(shape));
+            break;
+        case b2_capsuleShape:
+            writer.write<b2Capsule>(b2Shape_GetCapsule(shape));
+            break;
+        case b2_segmentShape:
+            writer.write<b2Segment>(b2Shape_GetSegment(shape));
+            break;
+        case b2_polygonShape:
+            writer.write<b2Polygon>(b2Shape_GetPolygon(shape));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void Collider::readColliderSnapshot(SnapshotReader& reader)
+{
+    CHECK_IF_IN_PHYSICS_UPDATE_EDITING_DATA();
+
+    b2BodyType type = (b2BodyType)reader.read<std::int32_t>();
+    bool enabled = reader.read<std::uint8_t>();
+    bool awake = reader.read<std::uint8_t>();
+    bool sleepEnabled = reader.read<std::uint8_t>();
+    bool bullet = reader.read<std::uint8_t>();
+    bool fixedRotation = reader.read<std::uint8_t>();
+    b2Vec2 linearVelocity = reader.read<b2Vec2>();
+    float angularVelocity = reader.read<float>();
+
+    b2Body_SetType(m_body, type);
+    b2Body_EnableSleep(m_body, sleepEnabled);
+    b2Body_SetBullet(m_body, bullet);
+    b2Body_SetFixedRotation(m_body, fixedRotation);
+    b2Body_SetLinearDamping(m_body, reader.read<float>());
+    b2Body_SetAngularDamping(m_body, reader.read<float>());
+    b2Body_SetGravityScale(m_body, reader.read<float>());
+    b2Body_SetSleepThreshold(m_body, reader.read<float>());
+
+    // fixtures made by the constructor are reused in order while they match the saved ones so they are not destroyed and created again
+    std::vector<b2ShapeId> shapes(b2Body_GetShapeCount(m_body));
+    b2Body_GetShapes(m_body, shapes.data(), (int)shapes.size());
+    // chain segments are owned by chains which are not supported yet
+    shapes.erase(std::remove_if(shapes.begin(), shapes.end(), [](b2ShapeId shape){ return b2Shape_GetType(shape) == b2_chainSegmentShape; }), shapes.end());
+    std::size_t next = 0;
+
+    std::int32_t count = reader.read<std::int32_t>();
+    for (std::int32_t i = 0; i < count && reader.isValid(); i++)
+    {
+        b2ShapeType shapeType = (b2ShapeType)reader.read<std::int32_t>();
+        float density = reader.read<float>();
+        float friction = reader.read<float>();
+        float restitution = reader.read<float>();
+        b2Filter filter = reader.read<b2Filter>();
+        bool sensor = reader.read<std::uint8_t>();
+        bool sensorEvents = reader.read<std::uint8_t>();
+        bool contactEvents = reader.read<std::uint8_t>();
+        bool preSolveEvents = reader.read<std::uint8_t>();
+
+        b2ShapeId shape = next < shapes.size() ? shapes[next] : b2_nullShapeId;
+        bool reuse = B2_IS_NON_NULL(shape) && b2Shape_GetType(shape) == shapeType && b2Shape_IsSensor(shape) == sensor;
+        FixtureDef fixtureDef;
+        if (!reuse)
+        {
+            fixtureDef.setDensity(density);
+            fixtureDef.setFriction(friction);
+            fixtureDef.setRestitution(restitution);
+            fixtureDef.m_shapeDef.filter = filter;
+            fixtureDef.setAsSensor(sensor);
+            fixtureDef.enableSensorEvents(sensorEvents);
+            fixtureDef.enableContactEvents(contactEvents);
+            fixtureDef.enablePreSolveEvents(preSolveEvents);
+        }
+
+        switch (shapeType)
+        {
+        case b2_circleShape:
+        {
+            b2Circle circle = reader.read<b2Circle>();
+            if (!reader.isValid())
+                reuse = false;
+            else if (!reuse)
+                b2CreateCircleShape(m_body, &fixtureDef.m_shapeDef, &circle);
+            else if (b2Circle current = b2Shape_GetCircle(shape); std::memcmp(&current, &circle, sizeof(b2Circle)) != 0)
+                b2Shape_SetCircle(shape, &circle);
+            break;
+        }
+        case b2_capsuleShape:
+        {
+            b2Capsule capsule = reader.read<b2Capsule>();
+            if (!reader.isValid())
+                reuse = false;
+            else if (!reuse)
+                b2CreateCapsuleShape(m_body, &fixtureDef.m_shapeDef, &capsule);
+            else if (b2Capsule current = b2Shape_GetCapsule(shape); std::memcmp(&current, &capsule, sizeof(b2Capsule)) != 0)
+                b2Shape_SetCapsule(shape, &capsule);
+            break;
+        }
+        case b2_segmentShape:
+        {
+            b2Segment segment = reader.read<b2Segment>();
+            if (!reader.isValid())
+                reuse = false;
+            else if (!reuse)
+                b2CreateSegmentShape(m_body, &fixtureDef.m_shapeDef, &segment);
+            else if (b2Segment current = b2Shape_GetSegment(shape); std::memcmp(&current, &segment, sizeof(b2Segment)) != 0)
+                b2Shape_SetSegment(shape, &segment);
+            break;
+        }
+        case b2_polygonShape:
+        {
+            b2Polygon polygon = reader.read<b2Polygon>();
+            // box2d trusts the vertex count so polygons from corrupt data are skipped
+            if (!reader.isValid() || polygon.count < 3 || polygon.count > B2_MAX_POLYGON_VERTICES)
+                reuse = false;
+            else if (!reuse)
+                b2CreatePolygonShape(m_body, &fixtureDef.m_shapeDef, &polygon);
+            else if (b2Polygon current = b2Shape_GetPolygon(shape); std::memcmp(&current, &polygon, sizeof(b2Polygon)) != 0)
+                b2Shape_SetPolygon(shape, &polygon);
+            break;
+        }
+        default:
+            reuse = false;
+            break;
+        }
+
+        if (!reuse)
+            continue;
+        next++;
+        if (b2Shape_GetDensity(shape) != density)
+            b2Shape_SetDensity(shape, density, false);
+        b2Shape_SetFriction(shape, friction);
+        b2Shape_SetRestitution(shape, restitution);
+        b2Filter current = b2Shape_GetFilter(shape);
+        if (current.categoryBits != filter.categoryBits || current.maskBits != filter.maskBits || current.groupIndex != filter.groupIndex)
+            b2Shape_SetFilter(shape, filter);
+        b2Shape_EnableSensorEvents(shape, sensorEvents);
+        b2Shape_EnableContactEvents(shape, contactEvents);
+        b2Shape_EnablePreSolveEvents(shape, preSolveEvents);
+    }
+    // fixtures from the constructor that are not in the snapshot
+    for (; next < shapes.size(); next++)
+    {
+        b2DestroyShape(shapes[next], false);
+    }
+    b2Body_ApplyMassFromShapes(m_body);
+
+    // set after the shapes since the type and mass can change the velocity
+    b2Body_SetLinearVelocity(m_body, linearVelocity);
+    b2Body_SetAngularVelocity(m_body, angularVelocity);
+    m_enabled = enabled;
+    m_updatePhysicsState();
+    if (isPhysicsEnabled())
+        b2Body_SetAwake(m_body, awake);
+}
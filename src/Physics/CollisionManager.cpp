@@ -54,6 +54,17 @@ bool CollisionManager::PreSolve(b2ShapeId shapeIdA, b2ShapeId shapeIdB, b2Manifo
     return shouldCollide;
 }
 
+void CollisionManager::updateBodyTransforms()
+{
+    b2BodyEvents events = b2World_GetBodyEvents(WorldHandler::get().getWorld());
+
+    for (std::int32_t i = 0; i < events.moveCount; i++)
+    {
+        if (b2Body_IsValid(events.moveEvents[i].bodyId))
+            ((Collider*)(events.moveEvents[i].userData))->m_update(&events.moveEvents[i].transform);
+    }
+}
+
 void CollisionManager::Update()
 {
     // There should be no need to care about multiple threads here
@@ -63,17 +74,6 @@ void CollisionManager::Update()
         m_threadedEvents[i].second.disconnectAll();
     }
 
-    // updating the position of the objects for bodies that moved
-    {
-        b2BodyEvents events = b2World_GetBodyEvents(WorldHandler::get().getWorld());
-
-        for (std::int32_t i = 0; i < events.moveCount; i++)
-        {
-            if (b2Body_IsValid(events.moveEvents[i].bodyId))
-                ((Collider*)(events.moveEvents[i].userData))->m_update(&events.moveEvents[i].transform);
-        }
-    }
-
     // !!!!!! This could end up being very bad if box2d ever uses the last bit of the flags
     // !!!!!! also could be very bad if the flags are ever reset by box2d
     #define WAS_TOUCHING_FLAG 0b10000000000000000000000000000000
@@ -157,6 +157,11 @@ void CollisionManager::removeCollider(Collider* collider)
     m_objects.erase({collider});
 }
 
+void CollisionManager::reserve(std::size_t count)
+{
+    m_objects.reserve(m_objects.size() + count);
+}
+
 void CollisionManager::initWorkerThreadLists(unsigned int workers)
 {
     m_threadedEventsSize = workers;
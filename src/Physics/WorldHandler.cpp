@@ -60,7 +60,7 @@ b2WorldId WorldHandler::getWorld() const
     return m_world;
 }
 
-void WorldHandler::updateWorld(double deltaTime)
+void WorldHandler::updateWorld(double deltaTime, const std::function<void()>& onTick)
 {
     CHECK_VALID_WORLD();
     m_accumulate += deltaTime;
@@ -72,7 +72,11 @@ void WorldHandler::updateWorld(double deltaTime)
     m_interpolateTime = m_accumulate > m_maxInterpolateTime ? m_maxInterpolateTime : m_accumulate;
     while (updates > 0)
     {
+        if (onTick)
+            onTick();
         b2World_Step(m_world, tickTime, m_substepCount);
+        // body events only have the last step so the objects are moved after every step
+        CollisionManager::get()->updateBodyTransforms();
         updates--;
     }
 }
@@ -0,0 +1,170 @@
+#include "Prefab.hpp"
+#include "ObjectManager.hpp"
+#include "TransformStore.hpp"
+#include "UpdateManager.hpp"
+#include "Graphics/DrawableManager.hpp"
+#include "Physics/CollisionManager.hpp"
+
+#include <sstream>
+
+Prefab::Prefab(Object* root)
+{
+    capture(root);
+}
+
+bool Prefab::capture(Object* root)
+{
+    std::ostringstream stream(std::ios::binary);
+    if (root == nullptr || !SceneSnapshot::save(stream, {root}))
+    {
+        load(nullptr, 0);
+        return false;
+    }
+
+    std::string data = std::move(stream).str();
+    return load(data.data(), data.size());
+}
+
+bool Prefab::load(const void* data, std::size_t size)
+{
+    m_counted = false;
+    m_updateCount = 0;
+    m_colliderCount = 0;
+    if (data == nullptr)
+        m_data.clear();
+    else
+        m_data.assign(static_cast<const char*>(data), static_cast<const char*>(data) + size);
+
+    bool valid = SceneSnapshot::m_decode(m_data, m_types, m_records) && !m_records.empty() && m_records.front().entry != nullptr;
+    // every object besides the root has to be in the same subtree
+    for (std::size_t i = 1; i < m_records.size() && valid; i++)
+    {
+        valid = m_records[i].parent < i;
+    }
+    if (!valid)
+    {
+        m_data.clear();
+        m_types.clear();
+        m_records.clear();
+        return false;
+    }
+    return true;
+}
+
+const std::vector<char>& Prefab::getData() const
+{
+    return m_data;
+}
+
+bool Prefab::isValid() const
+{
+    return !m_records.empty();
+}
+
+std::size_t Prefab::getNumberOfObjects() const
+{
+    return m_records.size();
+}
+
+Object* Prefab::instantiate()
+{
+    std::vector<Object*> roots = m_instantiate(1, nullptr);
+    return roots.empty() ? nullptr : roots.front();
+}
+
+Object* Prefab::instantiate(const Transform& transform)
+{
+    std::vector<Object*> roots = m_instantiate(1, &transform);
+    return roots.empty() ? nullptr : roots.front();
+}
+
+std::vector<Object*> Prefab::instantiate(std::size_t count)
+{
+    return m_instantiate(count, nullptr);
+}
+
+std::vector<Object*> Prefab::instantiate(const std::vector<Transform>& transforms)
+{
+    return m_instantiate(transforms.size(), transforms.data());
+}
+
+std::vector<Object*> Prefab::m_instantiate(std::size_t count, const Transform* transforms)
+{
+    if (!isValid() || count == 0)
+        return {};
+
+    std::vector<Object*> roots;
+    roots.reserve(count);
+    // the first copy is used to find how many objects each manager gets per copy
+    if (!m_counted)
+    {
+        roots.emplace_back(m_createCopy(transforms));
+        m_countManaged();
+    }
+
+    std::size_t remaining = count - roots.size();
+    if (remaining == 0)
+        return roots;
+
+    // reserving everything up front so nothing reallocates or rehashes while creating the copies
+    for (auto& type: m_types)
+    {
+        if (type.first != nullptr)
+            type.first->reserve((std::size_t)type.second * remaining);
+    }
+    ObjectManager::reserve(m_records.size() * remaining);
+    TransformStore::reserve(m_records.size() * remaining);
+    UpdateManager::reserve(m_updateCount * remaining);
+    CollisionManager::get()->reserve(m_colliderCount * remaining);
+
+    DrawableManager::beginBatch();
+    for (std::size_t i = roots.size(); i < count; i++)
+    {
+        roots.emplace_back(m_createCopy(transforms == nullptr ? nullptr : transforms + i));
+    }
+    DrawableManager::endBatch();
+
+    return roots;
+}
+
+Object* Prefab::m_createCopy(const Transform* transform)
+{
+    m_objects.clear();
+    m_roots.clear();
+    for (std::size_t i = 0; i < m_records.size(); i++)
+    {
+        const SceneSnapshot::m_objectRecord* record = &m_records[i];
+        SceneSnapshot::m_objectRecord rootRecord;
+        if (i == 0 && transform != nullptr)
+        {
+            rootRecord = *record;
+            rootRecord.transform = *transform;
+            record = &rootRecord;
+        }
+
+        Object* object = SceneSnapshot::m_createObject(*record, m_objects, m_roots);
+        if (object != nullptr)
+        {
+            SnapshotReader reader(m_data.data() + record->dataOffset, record->dataSize);
+            record->entry->read(*object, reader);
+        }
+        m_objects.emplace_back(object);
+    }
+
+    // only the first record can be a root since the prefab is a single subtree
+    return m_roots.front();
+}
+
+void Prefab::m_countManaged()
+{
+    m_counted = true;
+    for (Object* object: m_objects)
+    {
+        if (object == nullptr)
+            continue;
+        if (object->cast<UpdateInterface>() != nullptr)
+            m_updateCount++;
+        if (object->cast<Collider>() != nullptr)
+            m_colliderCount++;
+    }
+}
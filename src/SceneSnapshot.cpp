@@ -0,0 +1,356 @@
+#include "SceneSnapshot.hpp"
+#include "ObjectManager.hpp"
+#include "TransformStore.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+/// @brief "CGFS" used to check that a stream is a snapshot
+constexpr std::uint32_t SNAPSHOT_MAGIC = 0x53464743;
+constexpr std::uint32_t NO_PARENT = UINT32_MAX;
+
+std::unordered_map<std::type_index, SceneSnapshot::m_typeEntry>& SceneSnapshot::m_getTypes()
+{
+    static std::unordered_map<std::type_index, m_typeEntry> types;
+    return types;
+}
+
+const SceneSnapshot::m_typeEntry* SceneSnapshot::m_getEntry(const Object& object)
+{
+    auto entry = m_getTypes().find(std::type_index(typeid(object)));
+    if (entry == m_getTypes().end())
+        return nullptr;
+    return &entry->second;
+}
+
+bool SceneSnapshot::save(std::ostream& stream)
+{
+    std::vector<Object*> roots;
+    for (Object* object: ObjectManager::getObjects())
+    {
+        if (object->getParentRaw() == nullptr)
+            roots.emplace_back(object);
+    }
+    return save(stream, roots);
+}
+
+bool SceneSnapshot::save(std::ostream& stream, const std::vector<Object*>& roots)
+{
+    // parents are always before their children so they exist when the children are loaded
+    std::vector<Object*> objects;
+    std::vector<std::uint32_t> parents;
+    std::vector<const m_typeEntry*> entries;
+    std::unordered_map<const m_typeEntry*, std::pair<std::uint32_t, std::uint64_t>> typeTable; // index and count
+    std::vector<const m_typeEntry*> typeOrder;
+
+    std::vector<std::pair<Object*, std::uint32_t>> stack; // object and parent index
+    for (auto root = roots.rbegin(); root != roots.rend(); root++)
+    {
+        stack.emplace_back(*root, NO_PARENT);
+    }
+    while (!stack.empty())
+    {
+        auto [object, parent] = stack.back();
+        stack.pop_back();
+
+        const m_typeEntry* entry = m_getEntry(*object);
+        if (entry == nullptr || object->isDestroyQueued())
+            continue;
+
+        auto type = typeTable.try_emplace(entry, (std::uint32_t)typeOrder.size(), 0);
+        if (type.second)
+            typeOrder.emplace_back(entry);
+        type.first->second.second++;
+
+        std::uint32_t index = (std::uint32_t)objects.size();
+        objects.emplace_back(object);
+        parents.emplace_back(parent);
+        entries.emplace_back(entry);
+
+        // pushed in reverse so children keep their order
+        std::size_t first = stack.size();
+        for (Object* child: object->m_children)
+        {
+            stack.emplace_back(child, index);
+        }
+        std::reverse(stack.begin() + first, stack.end());
+    }
+
+    SnapshotWriter writer(stream);
+    writer.write<std::uint32_t>(SNAPSHOT_MAGIC);
+    writer.write<std::uint32_t>(VERSION);
+
+    writer.write<std::uint32_t>((std::uint32_t)typeOrder.size());
+    for (const m_typeEntry* entry: typeOrder)
+    {
+        writer.writeString(entry->name);
+        writer.write<std::uint64_t>(typeTable[entry].second);
+    }
+
+    writer.write<std::uint64_t>(objects.size());
+    for (std::size_t i = 0; i < objects.size(); i++)
+    {
+        Object* object = objects[i];
+        Transform transform = object->getTransform();
+        writer.write<std::uint32_t>(typeTable[entries[i]].first);
+        writer.write<std::uint32_t>(parents[i]);
+        writer.write<float>(transform.position.x);
+        writer.write<float>(transform.position.y);
+        writer.write<float>(transform.rotation.cos);
+        writer.write<float>(transform.rotation.sin);
+        writer.write<std::uint64_t>(object->getUserType());
+        writer.write<std::uint8_t>(object->m_enabled);
+
+        writer.beginBlock();
+        entries[i]->write(*object, writer);
+        writer.endBlock();
+    }
+    writer.flush();
+
+    return writer.isValid();
+}
+
+bool SceneSnapshot::save(const std::string& filePath)
+{
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+    return save(file);
+}
+
+std::vector<Object*> SceneSnapshot::load(std::istream& stream)
+{
+    SnapshotReader reader(stream);
+    std::vector<std::pair<const m_typeEntry*, std::uint64_t>> types;
+    if (!m_readHeader(reader, types))
+        return {};
+
+    for (auto& type: types)
+    {
+        // allocating everything up front so objects of the same type are next to each other
+        if (type.first != nullptr)
+            type.first->reserve((std::size_t)type.second);
+    }
+
+    std::uint64_t objectCount = reader.read<std::uint64_t>();
+    if (!reader.isValid())
+        return {};
+    ObjectManager::reserve((std::size_t)objectCount);
+    TransformStore::reserve((std::size_t)objectCount);
+
+    std::vector<Object*> objects;
+    objects.reserve((std::size_t)objectCount);
+    std::vector<Object*> roots;
+    for (std::uint64_t i = 0; i < objectCount && reader.isValid(); i++)
+    {
+        m_objectRecord record = m_readRecord(reader, types);
+        Object* object = m_createObject(record, objects, roots);
+        if (object != nullptr)
+            record.entry->read(*object, reader);
+        objects.emplace_back(object);
+        reader.endBlock();
+    }
+
+    if (!reader.isValid())
+    {
+        for (Object* root: roots)
+        {
+            root->destroy();
+        }
+        return {};
+    }
+
+    return roots;
+}
+
+std::vector<Object*> SceneSnapshot::load(const std::string& filePath)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+        return {};
+    return load(file);
+}
+
+bool SceneSnapshot::m_readHeader(SnapshotReader& reader, std::vector<std::pair<const m_typeEntry*, std::uint64_t>>& types)
+{
+    if (reader.read<std::uint32_t>() != SNAPSHOT_MAGIC || reader.read<std::uint32_t>() != VERSION)
+        return false;
+
+    std::unordered_map<std::string, const m_typeEntry*> names;
+    for (auto& type: m_getTypes())
+    {
+        names[type.second.name] = &type.second;
+    }
+
+    std::uint32_t typeCount = reader.read<std::uint32_t>();
+    types.clear();
+    for (std::uint32_t i = 0; i < typeCount && reader.isValid(); i++)
+    {
+        std::string name = reader.readString();
+        std::uint64_t count = reader.read<std::uint64_t>();
+        auto entry = names.find(name);
+        types.emplace_back(entry == names.end() ? nullptr : entry->second, count);
+    }
+
+    return reader.isValid();
+}
+
+SceneSnapshot::m_objectRecord SceneSnapshot::m_readRecord(SnapshotReader& reader, const std::vector<std::pair<const m_typeEntry*, std::uint64_t>>& types)
+{
+    m_objectRecord record;
+    std::uint32_t typeIndex = reader.read<std::uint32_t>();
+    record.entry = typeIndex < types.size() ? types[typeIndex].first : nullptr;
+    record.parent = reader.read<std::uint32_t>();
+    float x = reader.read<float>();
+    float y = reader.read<float>();
+    float cos = reader.read<float>();
+    float sin = reader.read<float>();
+    record.transform = Transform(Vector2{x, y}, Rotation{cos, sin});
+    record.userType = reader.read<std::uint64_t>();
+    record.enabled = reader.read<std::uint8_t>();
+    record.dataSize = reader.beginBlock();
+    record.dataOffset = reader.getPosition();
+    return record;
+}
+
+Object* SceneSnapshot::m_createObject(const m_objectRecord& record, const std::vector<Object*>& objects, std::vector<Object*>& roots)
+{
+    // unknown types are skipped along with their children
+    if (record.entry == nullptr || (record.parent != NO_PARENT && (record.parent >= objects.size() || objects[record.parent] == nullptr)))
+        return nullptr;
+
+    Object* object = m_createObject(record, record.parent == NO_PARENT ? nullptr : objects[record.parent]);
+    if (record.parent == NO_PARENT)
+        roots.emplace_back(object);
+    return object;
+}
+
+Object* SceneSnapshot::m_createObject(const m_objectRecord& record, Object* parent)
+{
+    Object::m_initialState state{parent, record.transform, record.userType};
+    Object::m_nextInitialState = &state;
+    Object* object = record.entry->create();
+    // in case the constructor did not make it to Object (should never happen)
+    Object::m_nextInitialState = nullptr;
+    if (!record.enabled)
+        object->setEnabled(false);
+    // components only learn that they start disabled through the disabled event
+    else if (parent != nullptr && !parent->isEnabled())
+        object->m_onDisabled.invoke();
+    return object;
+}
+
+bool SceneSnapshot::m_decode(const std::vector<char>& data, std::vector<std::pair<const m_typeEntry*, std::uint64_t>>& types, std::vector<m_objectRecord>& records)
+{
+    SnapshotReader reader(data.data(), data.size());
+    if (!m_readHeader(reader, types))
+        return false;
+
+    std::uint64_t objectCount = reader.read<std::uint64_t>();
+    // every record is at least its type index so this stops huge allocations from bad data
+    if (!reader.isValid() || objectCount > data.size() / sizeof(std::uint32_t))
+        return false;
+    records.clear();
+    records.reserve((std::size_t)objectCount);
+    for (std::uint64_t i = 0; i < objectCount && reader.isValid(); i++)
+    {
+        records.emplace_back(m_readRecord(reader, types));
+        reader.endBlock();
+    }
+
+    return reader.isValid();
+}
+
+//* Incremental load
+
+bool SceneSnapshot::IncrementalLoad::decode(const void* data, std::size_t size)
+{
+    m_clear();
+    m_data.assign(static_cast<const char*>(data), static_cast<const char*>(data) + size);
+    if (!m_decode(m_data, m_types, m_records))
+    {
+        m_clear();
+        return false;
+    }
+    m_objects.reserve(m_records.size());
+    return true;
+}
+
+bool SceneSnapshot::IncrementalLoad::instantiate(std::chrono::steady_clock::time_point deadline)
+{
+    if (m_next == 0 && !m_records.empty())
+    {
+        for (auto& type: m_types)
+        {
+            if (type.first != nullptr)
+                type.first->reserve((std::size_t)type.second);
+        }
+        ObjectManager::reserve(m_records.size());
+        TransformStore::reserve(m_records.size());
+    }
+
+    while (m_next < m_records.size())
+    {
+        const m_objectRecord& record = m_records[m_next];
+        Object* parent = nullptr;
+        if (record.parent != NO_PARENT && record.parent < m_objects.size())
+            parent = ObjectManager::getObjectRaw(m_objects[record.parent]);
+        Object* object = nullptr;
+        // unknown types are skipped along with their children, as are children of objects destroyed since they were created
+        if (record.entry != nullptr && (record.parent == NO_PARENT || (parent != nullptr && !parent->isDestroyQueued())))
+        {
+            object = m_createObject(record, parent);
+            if (parent == nullptr)
+                m_roots.emplace_back(object);
+            SnapshotReader reader(m_data.data() + record.dataOffset, record.dataSize);
+            record.entry->read(*object, reader);
+        }
+        m_objects.emplace_back(object != nullptr ? object->getID() : 0);
+        m_next++;
+
+        // checking the time every few objects since most objects are very quick to create
+        if (m_next % 16 == 0 && std::chrono::steady_clock::now() >= deadline)
+            break;
+    }
+
+    if (isDone())
+    {
+        // the decoded data is no longer needed
+        m_data = {};
+        m_records = {};
+        m_objects = {};
+        return true;
+    }
+    return false;
+}
+
+bool SceneSnapshot::IncrementalLoad::isDone() const
+{
+    return m_next >= m_records.size();
+}
+
+const std::vector<Object::Ptr<>>& SceneSnapshot::IncrementalLoad::getRoots() const
+{
+    return m_roots;
+}
+
+void SceneSnapshot::IncrementalLoad::cancel()
+{
+    for (Object::Ptr<>& root: m_roots)
+    {
+        // roots given a parent by gameplay belong to that parent now
+        if (root && root->getParentRaw() == nullptr)
+            root->destroy();
+    }
+    m_clear();
+}
+
+void SceneSnapshot::IncrementalLoad::m_clear()
+{
+    m_data = {};
+    m_types.clear();
+    m_records = {};
+    m_objects = {};
+    m_roots.clear();
+    m_next = 0;
+}
@@ -0,0 +1,159 @@
+#include "SnapshotStream.hpp"
+
+#include <algorithm>
+
+//* Writer
+
+SnapshotWriter::SnapshotWriter(std::ostream& stream) : m_stream(stream)
+{
+    m_buffer.reserve(m_flushSize * 2);
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    flush();
+}
+
+void SnapshotWriter::writeBytes(const void* data, std::size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+    if (m_buffer.size() >= m_flushSize && m_blockStart == SIZE_MAX)
+        flush();
+}
+
+void SnapshotWriter::writeString(const std::string& str)
+{
+    write<std::uint32_t>((std::uint32_t)str.size());
+    writeBytes(str.data(), str.size());
+}
+
+void SnapshotWriter::beginBlock()
+{
+    m_blockStart = m_buffer.size();
+    // the size is filled in when the block ends
+    m_buffer.resize(m_buffer.size() + sizeof(std::uint32_t));
+}
+
+void SnapshotWriter::endBlock()
+{
+    std::uint32_t size = (std::uint32_t)(m_buffer.size() - m_blockStart - sizeof(std::uint32_t));
+    std::memcpy(m_buffer.data() + m_blockStart, &size, sizeof(std::uint32_t));
+    m_blockStart = SIZE_MAX;
+    if (m_buffer.size() >= m_flushSize)
+        flush();
+}
+
+void SnapshotWriter::flush()
+{
+    if (m_buffer.empty() || m_blockStart != SIZE_MAX)
+        return;
+    m_stream.write(m_buffer.data(), (std::streamsize)m_buffer.size());
+    m_buffer.clear();
+}
+
+bool SnapshotWriter::isValid() const
+{
+    return m_stream.good();
+}
+
+//* Reader
+
+SnapshotReader::SnapshotReader(std::istream& stream) : m_stream(&stream) {}
+
+SnapshotReader::SnapshotReader(const void* data, std::size_t size) : m_data(static_cast<const char*>(data)), m_size(size) {}
+
+bool SnapshotReader::readBytes(void* data, std::size_t size)
+{
+    if (!m_valid || m_consumed + size > m_blockEnd || !m_fill(size))
+    {
+        m_valid = false;
+        std::memset(data, 0, size);
+        return false;
+    }
+    std::memcpy(data, m_data + m_position, size);
+    m_position += size;
+    m_consumed += size;
+    return true;
+}
+
+std::string SnapshotReader::readString()
+{
+    std::uint32_t size = read<std::uint32_t>();
+    // checked before allocating so a corrupt size can not allocate more than the data that is left
+    if (!m_valid || m_consumed + size > m_blockEnd || (m_stream == nullptr && m_position + size > m_size))
+    {
+        m_valid = false;
+        return "";
+    }
+
+    // streams do not know how much data is left so the string only grows as the data is read
+    std::string str;
+    while (str.size() < size)
+    {
+        std::size_t offset = str.size();
+        str.resize(offset + std::min<std::size_t>(size - offset, m_readSize));
+        if (!readBytes(str.data() + offset, str.size() - offset))
+            return "";
+    }
+    return str;
+}
+
+std::uint32_t SnapshotReader::beginBlock()
+{
+    std::uint32_t size = read<std::uint32_t>();
+    m_blockEnd = m_consumed + size;
+    return size;
+}
+
+void SnapshotReader::endBlock()
+{
+    if (m_blockEnd == UINT64_MAX)
+        return;
+    std::uint64_t end = m_blockEnd;
+    m_blockEnd = UINT64_MAX;
+    if (m_valid && m_consumed < end)
+        m_skip((std::size_t)(end - m_consumed));
+}
+
+std::uint64_t SnapshotReader::getPosition() const
+{
+    return m_consumed;
+}
+
+bool SnapshotReader::isValid() const
+{
+    return m_valid;
+}
+
+bool SnapshotReader::m_fill(std::size_t size)
+{
+    std::size_t available = m_size - m_position;
+    if (available >= size)
+        return true;
+    if (m_stream == nullptr)
+        return false;
+
+    // move the unread data to the front so the buffer does not keep growing
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + m_position);
+    m_position = 0;
+
+    std::size_t toRead = std::max(size - available, m_readSize);
+    m_buffer.resize(available + toRead);
+    m_stream->read(m_buffer.data() + available, (std::streamsize)toRead);
+    m_buffer.resize(available + (std::size_t)m_stream->gcount());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    return m_size >= size;
+}
+
+void SnapshotReader::m_skip(std::size_t size)
+{
+    if (!m_fill(size))
+    {
+        m_valid = false;
+        return;
+    }
+    m_position += size;
+    m_consumed += size;
+}
@@ -0,0 +1,263 @@
+#include "TransformStore.hpp"
+#include "Object.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <future>
+
+std::vector<float> TransformStore::m_positionX;
+std::vector<float> TransformStore::m_positionY;
+std::vector<float> TransformStore::m_rotationCos;
+std::vector<float> TransformStore::m_rotationSin;
+std::vector<std::uint32_t> TransformStore::m_parent;
+std::vector<Object*> TransformStore::m_owner;
+std::vector<Transform> TransformStore::m_global;
+std::vector<Transform> TransformStore::m_interpolatedGlobal;
+std::vector<std::uint32_t> TransformStore::m_hierarchyOrder;
+std::vector<std::uint32_t> TransformStore::m_depthBands{0};
+std::vector<std::uint32_t> TransformStore::m_depth;
+bool TransformStore::m_hierarchyDirty = false;
+std::atomic<bool> TransformStore::m_globalsValid = false;
+std::atomic<bool> TransformStore::m_interpolatedValid = false;
+
+std::size_t TransformStore::size()
+{
+    return m_owner.size();
+}
+
+void TransformStore::reserve(std::size_t count)
+{
+    std::size_t total = m_owner.size() + count;
+    if (total <= m_owner.capacity())
+        return;
+    // growing at least geometrically so reserving often does not reallocate every time
+    total = std::max(total, m_owner.capacity() * 2);
+    m_positionX.reserve(total);
+    m_positionY.reserve(total);
+    m_rotationCos.reserve(total);
+    m_rotationSin.reserve(total);
+    m_parent.reserve(total);
+    m_owner.reserve(total);
+    m_global.reserve(total);
+    m_interpolatedGlobal.reserve(total);
+    m_hierarchyOrder.reserve(total);
+}
+
+const std::vector<float>& TransformStore::getPositionsX()
+{
+    return m_positionX;
+}
+
+const std::vector<float>& TransformStore::getPositionsY()
+{
+    return m_positionY;
+}
+
+const std::vector<float>& TransformStore::getRotationsCos()
+{
+    return m_rotationCos;
+}
+
+const std::vector<float>& TransformStore::getRotationsSin()
+{
+    return m_rotationSin;
+}
+
+const std::vector<std::uint32_t>& TransformStore::getParents()
+{
+    return m_parent;
+}
+
+const std::vector<Object*>& TransformStore::getOwners()
+{
+    return m_owner;
+}
+
+void TransformStore::updateGlobalTransforms(bool interpolate)
+{
+    // interpolated transforms change with the interpolation time and body velocities (not only setters) so they are always recomputed
+    if (m_globalsValid && !interpolate)
+        return;
+    if (m_hierarchyDirty)
+        m_updateHierarchyOrder();
+
+    m_global.resize(m_owner.size());
+    if (interpolate)
+        m_interpolatedGlobal.resize(m_owner.size());
+
+    std::uint32_t threads = std::max(ThreadPool::get().get_thread_count(), 1u);
+    std::vector<std::future<void>> tasks;
+    for (std::size_t depth = 0; depth + 1 < m_depthBands.size(); depth++)
+    {
+        std::uint32_t start = m_depthBands[depth];
+        std::uint32_t end = m_depthBands[depth + 1];
+        if (end - start < MIN_PARALLEL_DEPTH_SIZE || threads == 1)
+        {
+            m_updateGlobalRange(start, end, interpolate);
+            continue;
+        }
+
+        std::uint32_t range = (end - start + threads - 1) / threads;
+        for (std::uint32_t first = start + range; first < end; first += range)
+        {
+            tasks.emplace_back(ThreadPool::get().submit_task([first, last = std::min(first + range, end), interpolate]()
+            {
+                m_updateGlobalRange(first, last, interpolate);
+            }));
+        }
+        // the calling thread does the first range instead of only waiting
+        m_updateGlobalRange(start, start + range, interpolate);
+        // the next depth reads the global transforms of this depth
+        for (auto& task: tasks)
+        {
+            task.wait();
+        }
+        tasks.clear();
+    }
+
+    m_globalsValid = true;
+    if (interpolate)
+        m_interpolatedValid = true;
+}
+
+bool TransformStore::areGlobalTransformsValid()
+{
+    return m_globalsValid;
+}
+
+bool TransformStore::areInterpolatedTransformsValid()
+{
+    return m_interpolatedValid;
+}
+
+const std::vector<std::uint32_t>& TransformStore::getHierarchyOrder()
+{
+    if (m_hierarchyDirty)
+        m_updateHierarchyOrder();
+    return m_hierarchyOrder;
+}
+
+const std::vector<std::uint32_t>& TransformStore::getDepthBands()
+{
+    if (m_hierarchyDirty)
+        m_updateHierarchyOrder();
+    return m_depthBands;
+}
+
+std::uint32_t TransformStore::add(Object* owner)
+{
+    m_positionX.emplace_back(0.f);
+    m_positionY.emplace_back(0.f);
+    m_rotationCos.emplace_back(1.f);
+    m_rotationSin.emplace_back(0.f);
+    m_parent.emplace_back(NO_PARENT);
+    m_owner.emplace_back(owner);
+    m_invalidateGlobals();
+    m_hierarchyDirty = true;
+    return (std::uint32_t)(m_owner.size() - 1);
+}
+
+void TransformStore::remove(std::uint32_t index)
+{
+    std::uint32_t last = (std::uint32_t)(m_owner.size() - 1);
+    if (index != last)
+    {
+        m_positionX[index] = m_positionX[last];
+        m_positionY[index] = m_positionY[last];
+        m_rotationCos[index] = m_rotationCos[last];
+        m_rotationSin[index] = m_rotationSin[last];
+        m_parent[index] = m_parent[last];
+        m_owner[index] = m_owner[last];
+
+        Object* moved = m_owner[index];
+        moved->m_transformIndex = index;
+        // children still point at the old index
+        for (Object* child: moved->m_children)
+        {
+            m_parent[child->m_transformIndex] = index;
+        }
+    }
+
+    // the last global transforms are read after this (see getLastGlobal) so they are moved the same way
+    for (std::vector<Transform>* globals: {&m_global, &m_interpolatedGlobal})
+    {
+        if (index != last && index < globals->size())
+            (*globals)[index] = last < globals->size() ? (*globals)[last] : get(index);
+        if (globals->size() > last)
+            globals->resize(last);
+    }
+
+    m_positionX.pop_back();
+    m_positionY.pop_back();
+    m_rotationCos.pop_back();
+    m_rotationSin.pop_back();
+    m_parent.pop_back();
+    m_owner.pop_back();
+    m_invalidateGlobals();
+    m_hierarchyDirty = true;
+}
+
+void TransformStore::m_updateHierarchyOrder()
+{
+    m_hierarchyDirty = false;
+    std::uint32_t count = (std::uint32_t)m_owner.size();
+    m_depth.assign(count, NO_PARENT);
+
+    // finding the depth of every transform, each transform is only walked over once
+    std::uint32_t depths = 0;
+    std::vector<std::uint32_t> path;
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        std::uint32_t current = i;
+        while (current != NO_PARENT && m_depth[current] == NO_PARENT)
+        {
+            path.emplace_back(current);
+            current = m_parent[current];
+        }
+        std::uint32_t depth = current == NO_PARENT ? 0 : m_depth[current] + 1;
+        for (auto iter = path.rbegin(); iter != path.rend(); iter++)
+        {
+            m_depth[*iter] = depth++;
+        }
+        depths = std::max(depths, depth);
+        path.clear();
+    }
+
+    // counting sort by depth
+    m_depthBands.assign(depths + 1, 0);
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        m_depthBands[m_depth[i] + 1]++;
+    }
+    for (std::size_t depth = 1; depth < m_depthBands.size(); depth++)
+    {
+        m_depthBands[depth] += m_depthBands[depth - 1];
+    }
+    std::vector<std::uint32_t> next(m_depthBands.begin(), m_depthBands.end() - 1);
+    m_hierarchyOrder.resize(count);
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        m_hierarchyOrder[next[m_depth[i]]++] = i;
+    }
+}
+
+void TransformStore::m_updateGlobalRange(std::uint32_t start, std::uint32_t end, bool interpolate)
+{
+    for (std::uint32_t i = start; i < end; i++)
+    {
+        std::uint32_t index = m_hierarchyOrder[i];
+        std::uint32_t parent = m_parent[index];
+        if (parent == NO_PARENT)
+        {
+            m_global[index] = get(index);
+            if (interpolate)
+                m_interpolatedGlobal[index] = m_owner[index]->getInterpolatedTransform();
+        }
+        else
+        {
+            m_global[index] = m_global[parent] + get(index);
+            if (interpolate)
+                m_interpolatedGlobal[index] = m_interpolatedGlobal[parent] + m_owner[index]->getInterpolatedTransform();
+        }
+    }
+}
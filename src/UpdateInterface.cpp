@@ -7,6 +7,8 @@ UpdateInterface::UpdateInterface()
     // _onParentSet(&UpdateManager::removeUpdateObject, this);
 
     UpdateManager::addUpdateObject(this);
+    Object::m_onEnabled(&UpdateInterface::m_updateLists, this);
+    Object::m_onDisabled(&UpdateInterface::m_updateLists, this);
 }
 
 UpdateInterface::~UpdateInterface()
@@ -14,10 +16,70 @@ UpdateInterface::~UpdateInterface()
     UpdateManager::removeUpdateObject(this);
 }
 
-void UpdateInterface::Update(float deltaTime) {}
+void UpdateInterface::Update(float) {}
 
-void UpdateInterface::LateUpdate(float deltaTime) {}
+void UpdateInterface::LateUpdate(float) {}
 
 void UpdateInterface::FixedUpdate() {}
 
 void UpdateInterface::Start() {}
+
+void UpdateInterface::setThreadSafeUpdate(bool threadSafe)
+{
+    UpdateManager::setThreadSafe(this, threadSafe);
+}
+
+bool UpdateInterface::isThreadSafeUpdate() const
+{
+    return m_threadSafe;
+}
+
+void UpdateInterface::setUpdateInterval(std::uint32_t frames)
+{
+    UpdateManager::setInterval(this, frames, m_intervalSeconds, m_lod);
+}
+
+std::uint32_t UpdateInterface::getUpdateInterval() const
+{
+    return m_intervalFrames;
+}
+
+void UpdateInterface::setUpdateIntervalSeconds(float seconds)
+{
+    UpdateManager::setInterval(this, m_intervalFrames, seconds, m_lod);
+}
+
+float UpdateInterface::getUpdateIntervalSeconds() const
+{
+    return m_intervalSeconds;
+}
+
+void UpdateInterface::setUpdateLOD(bool lod)
+{
+    UpdateManager::setInterval(this, m_intervalFrames, m_intervalSeconds, lod);
+}
+
+bool UpdateInterface::isUpdateLOD() const
+{
+    return m_lod;
+}
+
+std::uint32_t UpdateInterface::getCurrentUpdateInterval() const
+{
+    return m_interval;
+}
+
+void UpdateInterface::setUpdateGroup(const std::string& group)
+{
+    UpdateManager::setGroup(this, group);
+}
+
+const std::string& UpdateInterface::getUpdateGroup() const
+{
+    return UpdateManager::m_groups[m_group]->name;
+}
+
+void UpdateInterface::m_updateLists()
+{
+    UpdateManager::updateLists(this);
+}
@@ -1,171 +1,557 @@
 #include "UpdateManager.hpp"
 #include "ObjectManager.hpp"
+#include "ThreadPool.hpp"
+#include "Graphics/CameraManager.hpp"
 
-std::unordered_set<UpdateInterface*> UpdateManager::m_objects;
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+
+std::vector<UpdateInterface*> UpdateManager::m_objects;
+std::vector<std::unique_ptr<UpdateManager::m_group>> UpdateManager::m_groups;
+std::vector<UpdateManager::m_group*> UpdateManager::m_groupOrder;
+std::unordered_map<std::string, std::uint32_t> UpdateManager::m_groupIndex;
+std::size_t UpdateManager::m_activeCount[UpdateManager::PHASES] = {};
+std::size_t UpdateManager::m_threadSafeCount = 0;
+bool UpdateManager::m_updating = false;
+bool UpdateManager::m_groupOrderDirty = false;
+std::vector<UpdateInterface*> UpdateManager::m_queued;
+std::mutex UpdateManager::m_queueLock;
+double UpdateManager::m_time[UpdateManager::PHASES] = {};
+std::uint64_t UpdateManager::m_frame[UpdateManager::PHASES] = {};
+float UpdateManager::m_averageDeltaTime = 1.f / 60.f;
+std::vector<std::pair<float, std::uint32_t>> UpdateManager::m_lodLevels = {{100.f, 2}, {200.f, 4}, {400.f, 8}};
+bool UpdateManager::m_hasCamera = false;
+Vector2 UpdateManager::m_cameraPosition;
+bool UpdateManager::m_parallelEnabled = true;
+std::size_t UpdateManager::m_parallelChunkSize = 256;
+bool UpdateManager::m_updatingInParallel = false;
+
+void UpdateManager::Update(float deltaTime)
+{
+    // smoothed so intervals in seconds do not jump between buckets from one slow frame
+    m_averageDeltaTime += (deltaTime - m_averageDeltaTime) * 0.1f;
+    Camera* camera = CameraManager::getMainCamera();
+    m_hasCamera = camera != nullptr;
+    if (m_hasCamera)
+        m_cameraPosition = camera->getGlobalPosition();
+
+    m_updatePhase((std::size_t)UpdateInterface::Phase::Update, deltaTime, [](UpdateInterface* obj, float deltaTime){ obj->Update(deltaTime); });
+}
+
+void UpdateManager::LateUpdate(float deltaTime)
+{
+    m_updatePhase((std::size_t)UpdateInterface::Phase::LateUpdate, deltaTime, [](UpdateInterface* obj, float deltaTime){ obj->LateUpdate(deltaTime); });
+}
+
+void UpdateManager::FixedUpdate()
+{
+    m_updatePhase((std::size_t)UpdateInterface::Phase::FixedUpdate, 0.f, [](UpdateInterface* obj, float){ obj->FixedUpdate(); });
+}
+
+void UpdateManager::Start()
+{
+    for (std::size_t i = 0; i < m_objects.size(); i++)
+    {
+        m_objects[i]->Start();
+    }
+}
+
+void UpdateManager::setGroupPriority(const std::string& group, int priority)
+{
+    std::unique_lock lock(m_queueLock, std::defer_lock);
+    if (m_updatingInParallel)
+        lock.lock();
+    m_groups[m_getGroup(group)]->priority = priority;
+    // the order can not change while it is being updated
+    if (m_updating)
+        m_groupOrderDirty = true;
+    else
+        m_sortGroups();
+}
+
+int UpdateManager::getGroupPriority(const std::string& group)
+{
+    auto iter = m_groupIndex.find(group);
+    return iter == m_groupIndex.end() ? 0 : m_groups[iter->second]->priority;
+}
+
+std::vector<std::string> UpdateManager::getGroups()
+{
+    std::vector<std::string> groups;
+    for (const m_group* group: m_groupOrder)
+    {
+        groups.emplace_back(group->name);
+    }
+    return groups;
+}
 
 void UpdateManager::addUpdateObject(UpdateInterface* obj)
 {
-    m_objects.insert({obj});
+    obj->m_group = m_getGroup(DEFAULT_GROUP);
+    obj->m_listedGroup = obj->m_group;
+    obj->m_index = m_objects.size();
+    m_objects.emplace_back(obj);
+    updateLists(obj);
 }
 
 void UpdateManager::removeUpdateObject(UpdateInterface* obj)
 {
-    m_objects.erase(obj);
-}
-
-// std::unordered_set<UpdateInterface*>::iterator getIterator(std::unordered_set<UpdateInterface*>::iterator start, uint64_t n)
-// {
-//     for (uint64_t i = 0; i < n; i++)
-//     {
-//         start++;
-//     }
-//     return start;
-// }
-
-// void UpdateManager::Update(float deltaTime, BS::thread_pool& pool)
-// {
-//     std::list<std::future<void>> threads;
-
-//     uint64_t partitionSize = m_objects.size()/pool.get_thread_count();
-//     uint64_t extra = m_objects.size()%pool.get_thread_count();
-//     uint64_t temp = 0;
-//     std::unordered_set<UpdateInterface*>::iterator current = m_objects.begin();
-//     std::unordered_set<UpdateInterface*>::iterator next;
-//     for (int i = 0; i < pool.get_thread_count(); i++)
-//     {
-//         temp = (extra > 0 ? 1 : 0);
-//         next = getIterator(current, partitionSize + temp);
-//         threads.emplace_back(pool.submit_task([deltaTime, current, next]{ _update(deltaTime, current, next); }));
-//         current = next;
-//         extra -= temp;
-//     }
-
-//     for (auto& thread: threads)
-//     {
-//         thread.wait();
-//     }
-
-//     threads.clear();
-// }
-
-// void UpdateManager::LateUpdate(float deltaTime, BS::thread_pool& pool)
-// {
-//     std::list<std::future<void>> threads;
-
-//     uint64_t partitionSize = m_objects.size()/pool.get_thread_count();
-//     uint64_t extra = m_objects.size()%pool.get_thread_count();
-//     uint64_t temp = 0;
-//     std::unordered_set<UpdateInterface*>::iterator current = m_objects.begin();
-//     std::unordered_set<UpdateInterface*>::iterator next;
-//     for (int i = 0; i < pool.get_thread_count(); i++)
-//     {
-//         temp = (extra > 0 ? 1 : 0);
-//         next = getIterator(current, partitionSize + temp);
-//         threads.emplace_back(pool.submit_task([deltaTime, current, next]{ _lateUpdate(deltaTime, current, next); }));
-//         current = next;
-//         extra -= temp;
-//     }
+    UpdateInterface* last = m_objects.back();
+    m_objects[obj->m_index] = last;
+    last->m_index = obj->m_index;
+    m_objects.pop_back();
+
+    if (obj->m_listsQueued)
+        std::erase(m_queued, obj);
+    for (std::size_t phase = 0; phase < PHASES; phase++)
+    {
+        m_removeFromList(obj, phase);
+    }
+    if (obj->m_threadSafe)
+        m_threadSafeCount--;
+}
+
+void UpdateManager::setThreadSafe(UpdateInterface* obj, bool threadSafe)
+{
+    if (obj->m_threadSafe == threadSafe)
+        return;
+    obj->m_threadSafe = threadSafe;
+    if (threadSafe)
+        m_threadSafeCount++;
+    else
+        m_threadSafeCount--;
+    updateLists(obj);
+}
+
+void UpdateManager::setGroup(UpdateInterface* obj, const std::string& group)
+{
+    std::uint32_t index;
+    {
+        std::unique_lock lock(m_queueLock, std::defer_lock);
+        if (m_updatingInParallel)
+            lock.lock();
+        index = m_getGroup(group);
+    }
+    if (obj->m_group == index)
+        return;
+    obj->m_group = index;
+    updateLists(obj);
+}
+
+void UpdateManager::setInterval(UpdateInterface* obj, std::uint32_t frames, float seconds, bool lod)
+{
+    obj->m_intervalFrames = std::max(frames, (std::uint32_t)1);
+    obj->m_intervalSeconds = std::max(seconds, 0.f);
+    obj->m_lod = lod;
+    m_updateInterval(obj);
+}
+
+void UpdateManager::setLODLevels(const std::vector<std::pair<float, std::uint32_t>>& levels)
+{
+    m_lodLevels = levels;
+    std::sort(m_lodLevels.begin(), m_lodLevels.end());
+}
+
+const std::vector<std::pair<float, std::uint32_t>>& UpdateManager::getLODLevels()
+{
+    return m_lodLevels;
+}
+
+void UpdateManager::updateLists(UpdateInterface* obj)
+{
+    if (!m_updating)
+    {
+        m_updateLists(obj);
+        return;
+    }
+
+    // the lists can not change while they are being updated
+    std::unique_lock lock(m_queueLock, std::defer_lock);
+    if (m_updatingInParallel)
+        lock.lock();
+    if (!obj->m_listsQueued)
+    {
+        obj->m_listsQueued = true;
+        m_queued.emplace_back(obj);
+    }
+}
+
+void UpdateManager::reserve(std::size_t count)
+{
+    std::size_t total = m_objects.size() + count;
+    if (total <= m_objects.capacity())
+        return;
+    // growing at least geometrically so reserving often does not reallocate every time
+    total = std::max(total, m_objects.capacity() * 2);
+    m_objects.reserve(total);
+    m_bucket& bucket = m_getIntervalLists(*m_groups[m_getGroup(DEFAULT_GROUP)], 1).buckets.front();
+    for (std::size_t phase = 0; phase < PHASES; phase++)
+    {
+        bucket.lists[phase].objects.reserve(total);
+    }
+}
+
+void UpdateManager::setParallelEnabled(bool enabled)
+{
+    m_parallelEnabled = enabled;
+}
+
+bool UpdateManager::isParallelEnabled()
+{
+    return m_parallelEnabled;
+}
+
+void UpdateManager::setParallelChunkSize(std::size_t size)
+{
+    m_parallelChunkSize = std::max(size, (std::size_t)1);
+}
+
+std::size_t UpdateManager::getParallelChunkSize()
+{
+    return m_parallelChunkSize;
+}
+
+bool UpdateManager::isUpdatingInParallel()
+{
+    return m_updatingInParallel;
+}
 
-//     for (auto& thread: threads)
-//     {
-//         thread.wait();
-//     }
+template <typename Function>
+void UpdateManager::m_updatePhase(std::size_t phase, float deltaTime, const Function& function)
+{
+    bool throttled = phase != (std::size_t)UpdateInterface::Phase::FixedUpdate;
+    m_time[phase] += deltaTime;
+    m_frame[phase]++;
+    double time = m_time[phase];
+    auto update = [&function, phase, time](UpdateInterface* obj)
+    {
+        // the time since this object was last updated so throttled objects get every frame they skipped
+        float deltaTime = (float)(time - obj->m_lastUpdate[phase]);
+        obj->m_lastUpdate[phase] = time;
+        function(obj, deltaTime);
+        if (obj->m_intervalSeconds > 0 || obj->m_lod)
+            m_updateInterval(obj);
+    };
 
-//     threads.clear();
-// }
+    m_updating = true;
+    for (m_group* group: m_groupOrder)
+    {
+        for (m_intervalLists& intervalLists: group->intervals)
+        {
+            // fixed updates are only in the lists that are updated every time
+            if (!throttled && intervalLists.interval != 1)
+                continue;
+            m_bucket& bucket = intervalLists.buckets[m_frame[phase] % intervalLists.interval];
+            m_prepare(bucket.threadSafeLists[phase], phase);
+            m_parallelUpdate(bucket.threadSafeLists[phase].objects, update);
+            m_prepare(bucket.lists[phase], phase);
+            m_serialUpdate(bucket.lists[phase].objects, update);
+        }
+    }
+    m_updating = false;
+    if (m_groupOrderDirty)
+        m_sortGroups();
+    m_applyQueued();
+}
 
-// void UpdateManager::FixedUpdate(BS::thread_pool& pool)
-// {
-//     std::list<std::future<void>> threads;
+template <typename Function>
+void UpdateManager::m_parallelUpdate(std::vector<UpdateInterface*>& list, const Function& function)
+{
+    std::size_t size = list.size();
+    std::size_t chunks = (size + m_parallelChunkSize - 1) / m_parallelChunkSize;
+    std::size_t helpers = std::min<std::size_t>(ThreadPool::get().get_thread_count(), chunks) - (chunks > 0 ? 1 : 0);
+    if (!m_parallelEnabled || helpers == 0)
+    {
+        m_serialUpdate(list, function);
+        return;
+    }
 
-//     uint64_t partitionSize = m_objects.size()/pool.get_thread_count();
-//     uint64_t extra = m_objects.size()%pool.get_thread_count();
-//     uint64_t temp = 0;
-//     std::unordered_set<UpdateInterface*>::iterator current = m_objects.begin();
-//     std::unordered_set<UpdateInterface*>::iterator next;
-//     for (int i = 0; i < pool.get_thread_count(); i++)
-//     {
-//         temp = (extra > 0 ? 1 : 0);
-//         next = getIterator(current, partitionSize + temp);
-//         threads.emplace_back(pool.submit_task([current, next]{ _fixedUpdate(current, next); }));
-//         current = next;
-//         extra -= temp;
-//     }
+    // transform updated events are queued and then called on the main thread once every thread is done
+    bool deferring = ObjectManager::isDeferringTransformUpdates();
+    ObjectManager::setDeferTransformUpdates(true);
+    m_updatingInParallel = true;
 
-//     for (auto& thread: threads)
-//     {
-//         thread.wait();
-//     }
+    // every thread takes the next chunk from the shared counter so threads that finish early take work from slower ones
+    std::atomic<std::size_t> nextChunk = 0;
+    auto work = [&list, &function, &nextChunk, chunks, size]()
+    {
+        for (std::size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed); chunk < chunks; chunk = nextChunk.fetch_add(1, std::memory_order_relaxed))
+        {
+            std::size_t end = std::min((chunk + 1) * m_parallelChunkSize, size);
+            for (std::size_t i = chunk * m_parallelChunkSize; i < end; i++)
+            {
+                if (list[i] != nullptr && list[i]->isEnabled())
+                    function(list[i]);
+            }
+        }
+    };
 
-//     threads.clear();
-// }
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(helpers);
+    for (std::size_t i = 0; i < helpers; i++)
+    {
+        tasks.emplace_back(ThreadPool::get().submit_task(work));
+    }
+    // every task has to finish before any exception is passed on since they use this stack frame
+    auto finish = [&tasks, deferring]()
+    {
+        for (auto& task: tasks)
+        {
+            task.wait();
+        }
+        m_updatingInParallel = false;
+        ObjectManager::setDeferTransformUpdates(deferring);
+    };
+    try
+    {
+        work();
+    }
+    catch (...)
+    {
+        // the other threads stop once there are no chunks left
+        nextChunk = chunks;
+        finish();
+        throw;
+    }
+    finish();
 
-// void UpdateManager::Start(BS::thread_pool& pool)
-// {
-//     std::list<std::future<void>> threads;
+    for (auto& task: tasks)
+    {
+        task.get();
+    }
+}
+
+template <typename Function>
+void UpdateManager::m_serialUpdate(std::vector<UpdateInterface*>& list, const Function& function)
+{
+    // objects are only added after updating so the size does not change
+    // objects disabled by an earlier update stay in the list until then so they are checked here
+    std::size_t size = list.size();
+    for (std::size_t i = 0; i < size; i++)
+    {
+        if (list[i] != nullptr && list[i]->isEnabled())
+            function(list[i]);
+    }
+}
+
+void UpdateManager::m_prepare(m_list& list, std::size_t phase)
+{
+    std::vector<UpdateInterface*>& objects = list.objects;
+    if (!list.needsCompact && list.sorted == objects.size())
+        return;
 
-//     uint64_t partitionSize = m_objects.size()/pool.get_thread_count();
-//     uint64_t extra = m_objects.size()%pool.get_thread_count();
-//     uint64_t temp = 0;
-//     std::unordered_set<UpdateInterface*>::iterator current = m_objects.begin();
-//     std::unordered_set<UpdateInterface*>::iterator next;
-//     for (int i = 0; i < pool.get_thread_count(); i++)
-//     {
-//         temp = (extra > 0 ? 1 : 0);
-//         next = getIterator(current, partitionSize + temp);
-//         threads.emplace_back(pool.submit_task([current, next]{ _start(current, next); }));
-//         current = next;
-//         extra -= temp;
-//     }
+    // the type (and so the phases it overrides) is only known once the object is done constructing
+    for (std::size_t i = list.sorted; i < objects.size(); i++)
+    {
+        if (objects[i] != nullptr && objects[i]->m_type == nullptr)
+            m_resolveType(objects[i]);
+    }
+
+    if (list.needsCompact)
+    {
+        list.needsCompact = false;
+        std::size_t sorted = 0;
+        std::size_t size = 0;
+        for (std::size_t i = 0; i < objects.size(); i++)
+        {
+            if (objects[i] == nullptr)
+                continue;
+            objects[size++] = objects[i];
+            if (i < list.sorted)
+                sorted++;
+        }
+        objects.resize(size);
+        list.sorted = sorted;
+    }
 
-//     for (auto& thread: threads)
-//     {
-//         thread.wait();
-//     }
+    if (list.sorted < objects.size())
+    {
+        // only the new objects are sorted and then merged into the already sorted objects
+        auto compare = [](const UpdateInterface* a, const UpdateInterface* b){ return a->m_type->before(*b->m_type); };
+        std::sort(objects.begin() + list.sorted, objects.end(), compare);
+        std::inplace_merge(objects.begin(), objects.begin() + list.sorted, objects.end(), compare);
+        list.sorted = objects.size();
+    }
+
+    for (std::size_t i = 0; i < objects.size(); i++)
+    {
+        objects[i]->m_listIndex[phase] = i;
+    }
+}
 
-//     threads.clear();
-// }
+void UpdateManager::m_resolveType(UpdateInterface* obj)
+{
+    // objects are done constructing once they are updated so objects created with new can keep their type for casts as well
+    Object* object = obj;
+    ObjectTypeInfo* info = object->m_typeInfo.load(std::memory_order_relaxed);
+    if (info == nullptr)
+    {
+        info = &ObjectTypeInfo::get(typeid(*obj));
+        object->m_typeInfo.store(info, std::memory_order_relaxed);
+    }
+    obj->m_type = &info->getType();
+    obj->m_overrides = info->getUpdatePhases();
+    // removing only clears the entry so this is safe while updating
+    for (std::size_t phase = 0; phase < PHASES; phase++)
+    {
+        if (!(obj->m_overrides & (1 << phase)))
+            m_removeFromList(obj, phase);
+    }
+}
 
-void UpdateManager::_update(float deltaTime, std::unordered_set<UpdateInterface*>::iterator begin, std::unordered_set<UpdateInterface*>::iterator end)
+void UpdateManager::m_applyQueued()
 {
-    while (begin != end)
+    for (UpdateInterface* obj: m_queued)
     {
-        if ((*begin)->isEnabled())
-            (*begin)->Update(deltaTime);
-        begin++;
+        obj->m_listsQueued = false;
+        m_updateLists(obj);
     }
+    m_queued.clear();
 }
 
-void UpdateManager::_lateUpdate(float deltaTime, std::unordered_set<UpdateInterface*>::iterator begin, std::unordered_set<UpdateInterface*>::iterator end)
+void UpdateManager::m_updateLists(UpdateInterface* obj)
 {
-    while (begin != end)
+    constexpr std::size_t fixedUpdate = (std::size_t)UpdateInterface::Phase::FixedUpdate;
+    bool enabled = obj->isEnabled();
+    bool moved = obj->m_listedGroup != obj->m_group || obj->m_inThreadSafeLists != obj->m_threadSafe;
+    bool rebucket = obj->m_listedGroup != obj->m_group || obj->m_listedInterval != obj->m_interval;
+
+    bool wasListed[PHASES];
+    for (std::size_t phase = 0; phase < PHASES; phase++)
     {
-        if ((*begin)->isEnabled())
-            (*begin)->LateUpdate(deltaTime);
-        begin++;
+        wasListed[phase] = obj->m_listIndex[phase] != UpdateInterface::NOT_LISTED;
+        bool wanted = enabled && (obj->m_overrides & (1 << phase));
+        if (wasListed[phase] && (!wanted || moved || (rebucket && phase != fixedUpdate)))
+            m_removeFromList(obj, phase);
+    }
+
+    if (rebucket)
+    {
+        // throttled objects are spread over the buckets of their interval so each frame updates about the same number
+        m_intervalLists& intervalLists = m_getIntervalLists(*m_groups[obj->m_group], obj->m_interval);
+        obj->m_listedBucket = intervalLists.nextBucket;
+        intervalLists.nextBucket = (intervalLists.nextBucket + 1) % intervalLists.interval;
+    }
+    obj->m_inThreadSafeLists = obj->m_threadSafe;
+    obj->m_listedGroup = obj->m_group;
+    obj->m_listedInterval = obj->m_interval;
+
+    for (std::size_t phase = 0; phase < PHASES; phase++)
+    {
+        bool wanted = enabled && (obj->m_overrides & (1 << phase));
+        if (!wanted || obj->m_listIndex[phase] != UpdateInterface::NOT_LISTED)
+            continue;
+        std::vector<UpdateInterface*>& list = m_getList(obj, phase).objects;
+        obj->m_listIndex[phase] = list.size();
+        list.emplace_back(obj);
+        m_activeCount[phase]++;
+        // objects that were not updated before (new or disabled) only get the time since now
+        if (!wasListed[phase])
+            obj->m_lastUpdate[phase] = m_time[phase];
     }
 }
 
-void UpdateManager::_fixedUpdate(std::unordered_set<UpdateInterface*>::iterator begin, std::unordered_set<UpdateInterface*>::iterator end)
+void UpdateManager::m_removeFromList(UpdateInterface* obj, std::size_t phase)
 {
-    while (begin != end)
+    std::size_t index = obj->m_listIndex[phase];
+    if (index == UpdateInterface::NOT_LISTED)
+        return;
+    m_list& list = m_getList(obj, phase);
+    // the entry is left empty so the list stays sorted and objects are not skipped while updating
+    list.objects[index] = nullptr;
+    list.needsCompact = true;
+    obj->m_listIndex[phase] = UpdateInterface::NOT_LISTED;
+    m_activeCount[phase]--;
+}
+
+UpdateManager::m_list& UpdateManager::m_getList(UpdateInterface* obj, std::size_t phase)
+{
+    bool fixedUpdate = phase == (std::size_t)UpdateInterface::Phase::FixedUpdate;
+    m_intervalLists& intervalLists = m_getIntervalLists(*m_groups[obj->m_listedGroup], fixedUpdate ? 1 : obj->m_listedInterval);
+    m_bucket& bucket = intervalLists.buckets[fixedUpdate ? 0 : obj->m_listedBucket];
+    return obj->m_inThreadSafeLists ? bucket.threadSafeLists[phase] : bucket.lists[phase];
+}
+
+UpdateManager::m_intervalLists& UpdateManager::m_getIntervalLists(m_group& group, std::uint32_t interval)
+{
+    auto iter = std::lower_bound(group.intervals.begin(), group.intervals.end(), interval, [](const m_intervalLists& lists, std::uint32_t interval){ return lists.interval < interval; });
+    if (iter != group.intervals.end() && iter->interval == interval)
+        return *iter;
+    iter = group.intervals.emplace(iter);
+    iter->interval = interval;
+    iter->buckets.resize(interval);
+    return *iter;
+}
+
+void UpdateManager::m_updateInterval(UpdateInterface* obj)
+{
+    std::uint32_t interval = obj->m_intervalFrames;
+    if (obj->m_intervalSeconds > 0)
+        interval = std::max(interval, (std::uint32_t)std::lround(obj->m_intervalSeconds / m_averageDeltaTime));
+    if (obj->m_lod && m_hasCamera)
     {
-        if ((*begin)->isEnabled())
-            (*begin)->FixedUpdate();
-        begin++;
+        // getGlobalPosition writes the cached global transform of every dirty parent which is not safe from the thread pool
+        // the transforms from the last frame are close enough to pick an interval
+        float distance = (TransformStore::getLastGlobal(obj->getTransformIndex()).position - m_cameraPosition).length();
+        for (const auto& level: m_lodLevels)
+        {
+            if (distance < level.first)
+                break;
+            interval = std::max(interval, level.second);
+        }
     }
+    interval = std::max(interval, (std::uint32_t)1);
+
+    if (interval != obj->m_interval)
+    {
+        obj->m_interval = interval;
+        updateLists(obj);
+    }
+}
+
+std::uint32_t UpdateManager::m_getGroup(const std::string& group)
+{
+    auto iter = m_groupIndex.find(group);
+    if (iter != m_groupIndex.end())
+        return iter->second;
+
+    std::uint32_t index = (std::uint32_t)m_groups.size();
+    m_groups.emplace_back(std::make_unique<m_group>());
+    m_groups.back()->name = group;
+    m_getIntervalLists(*m_groups.back(), 1);
+    m_groupIndex.emplace(group, index);
+    // the group is only updated once it is in the order which can not change while it is being updated
+    if (m_updating)
+        m_groupOrderDirty = true;
+    else
+        m_sortGroups();
+    return index;
 }
 
-void UpdateManager::_start(std::unordered_set<UpdateInterface*>::iterator begin, std::unordered_set<UpdateInterface*>::iterator end)
+void UpdateManager::m_sortGroups()
 {
-    while (begin != end)
+    m_groupOrderDirty = false;
+    m_groupOrder.clear();
+    for (const auto& group: m_groups)
     {
-        (*begin)->Start();
-        begin++;
+        m_groupOrder.emplace_back(group.get());
     }
+    std::stable_sort(m_groupOrder.begin(), m_groupOrder.end(), [](const m_group* a, const m_group* b){ return a->priority < b->priority; });
 }
 
-uint64_t UpdateManager::getNumberOfObjects()
+size_t UpdateManager::getNumberOfObjects()
 {
     return m_objects.size();
 }
+
+size_t UpdateManager::getNumberOfThreadSafeObjects()
+{
+    return m_threadSafeCount;
+}
+
+size_t UpdateManager::getNumberOfActiveObjects(UpdateInterface::Phase phase)
+{
+    return m_activeCount[(std::size_t)phase];
+}
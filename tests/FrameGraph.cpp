@@ -0,0 +1,52 @@
+// checks that the engine frame graph keeps the debug displays on the main thread and before the global transforms
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "Test.hpp"
+#include "Engine.hpp"
+
+int main()
+{
+    const std::vector<std::string> tasks = {"ActivationRegions", "Update", "TerminatingFunctions", "VarDisplay", "TFuncDisplay", "GlobalTransforms", "Physics", "Collisions", "LateUpdate"};
+
+    FrameGraph& graph = Engine::get().getFrameGraph();
+    Test::check(graph.getNumberOfTasks() == tasks.size(), "the engine adds every task before init");
+
+    // each task only records that it ran so nothing in the engine has to be initialized
+    const std::thread::id mainThread = std::this_thread::get_id();
+    std::vector<std::string> order;
+    bool allOnMainThread = true;
+    for (const std::string& name: tasks)
+    {
+        const bool display = name == "VarDisplay" || name == "TFuncDisplay";
+        graph.setTaskFunction(name, [&, name, display](){
+            allOnMainThread = allOnMainThread && std::this_thread::get_id() == mainThread;
+            order.emplace_back(name);
+            // the displays take the longest so they are on the critical path if anything waits for them
+            std::this_thread::sleep_for(std::chrono::milliseconds(display ? 5 : 1));
+        });
+    }
+    graph.run();
+
+    // the tasks touch widgets and objects so they must all run on the main thread in the order they were added
+    Test::check(allOnMainThread, "every engine task runs on the main thread");
+    Test::check(order == tasks, "the engine tasks run in the order they were added");
+
+    std::vector<std::size_t> path = graph.getCriticalPath();
+    std::vector<std::size_t> expected;
+    for (const std::string& name: tasks)
+    {
+        expected.emplace_back(graph.getTaskIndex(name));
+    }
+    Test::check(path == expected, "the critical path is every engine task in order");
+
+    auto position = [&path](std::size_t task){ return std::find(path.begin(), path.end(), task) - path.begin(); };
+    Test::check(position(graph.getTaskIndex("VarDisplay")) < position(graph.getTaskIndex("GlobalTransforms")) &&
+                position(graph.getTaskIndex("TFuncDisplay")) < position(graph.getTaskIndex("GlobalTransforms")),
+                "the debug displays finish before the global transforms are updated");
+
+    return Test::result("FrameGraph");
+}
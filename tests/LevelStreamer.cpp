@@ -0,0 +1,117 @@
+// checks that unloaded chunks are loaded from the level file when they did not change and from the backing file when they did
+
+#include <filesystem>
+
+#include "Test.hpp"
+#include "LevelStreamer.hpp"
+#include "ObjectManager.hpp"
+
+class Crate : public virtual Object {};
+
+constexpr float CHUNK_SIZE = 10.f;
+/// @brief far enough that the chunk at the origin is unloaded
+const Vector2 FAR_AWAY(1000.f, 0.f);
+
+static void clearObjects()
+{
+    ObjectManager::destroyAllObjects();
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+}
+
+/// @brief updates until every chunk in the load distance has all its objects
+static void loadAround(LevelStreamer& level, const Vector2& center)
+{
+    do
+    {
+        level.update(center);
+        ObjectManager::ClearDestroyQueue();
+    } while (!level.isIdle());
+    // objects destroyed by the last update are in the other destroy queue
+    ObjectManager::ClearDestroyQueue();
+}
+
+/// @returns the crate without a parent closest to the given position (nullptr if there are none)
+static Object* findCrate(const Vector2& position)
+{
+    Object* closest = nullptr;
+    for (Object* object: ObjectManager::getObjects())
+    {
+        if (object->getParentRaw() != nullptr || object->isDestroyQueued() || !object->isA<Crate>())
+            continue;
+        if (closest == nullptr || (object->getPosition() - position).length() < (closest->getPosition() - position).length())
+            closest = object;
+    }
+    return closest;
+}
+
+int main()
+{
+    SceneSnapshot::registerType<Crate>("Crate");
+
+    std::vector<Object*> roots;
+    for (int i = 0; i < 4; i++)
+    {
+        Crate* crate = new Crate();
+        crate->setPosition(1.f + (float)i, 1.f);
+        Crate* lid = new Crate();
+        lid->setParent(crate);
+        roots.emplace_back(crate);
+    }
+    const std::string levelPath = (std::filesystem::temp_directory_path() / "LevelStreamerTest.level").string();
+    const std::string savedPath = (std::filesystem::temp_directory_path() / "LevelStreamerTest.saved.level").string();
+    Test::check(LevelStreamer::writeLevel(levelPath, CHUNK_SIZE, roots), "the level is written");
+    clearObjects();
+
+    {
+        LevelStreamer level;
+        Test::check(level.open(levelPath), "the level is opened");
+        level.setLoadDistance(CHUNK_SIZE);
+        level.setUnloadDistance(CHUNK_SIZE * 2);
+
+        loadAround(level, Vector2());
+        Test::check(level.getNumberOfLoadedChunks() == 1 && ObjectManager::getNumberOfObjects() == 8, "the chunk is loaded");
+
+        // nothing changed so nothing is written
+        loadAround(level, FAR_AWAY);
+        Test::check(level.getNumberOfLoadedChunks() == 0 && ObjectManager::getNumberOfObjects() == 0, "the chunk is unloaded");
+        Test::check(level.getBackingFileSize() == 0, "an unchanged chunk is not written to the backing file");
+
+        loadAround(level, Vector2());
+        Object* crate = findCrate(Vector2(1.f, 1.f));
+        Test::check(crate != nullptr && ObjectManager::getNumberOfObjects() == 8, "an unchanged chunk is loaded from the level file again");
+
+        // changed chunks are written to the backing file
+        crate->setPosition(5.f, 5.f);
+        loadAround(level, FAR_AWAY);
+        std::uint64_t saved = level.getBackingFileSize();
+        Test::check(saved > 0, "a changed chunk is written to the backing file");
+
+        loadAround(level, Vector2());
+        crate = findCrate(Vector2(5.f, 5.f));
+        Test::check(crate != nullptr && crate->getPosition() == Vector2(5.f, 5.f) && ObjectManager::getNumberOfObjects() == 8, "a changed chunk is loaded from the backing file");
+
+        // saving the same chunk again reuses its space in the backing file
+        crate->setPosition(6.f, 6.f);
+        loadAround(level, FAR_AWAY);
+        Test::check(level.getBackingFileSize() == saved, "a chunk saved again is written over its last save");
+
+        // unloaded chunks are saved from the backing file
+        Test::check(level.save(savedPath), "the level is saved");
+    }
+    clearObjects();
+
+    {
+        LevelStreamer level;
+        Test::check(level.open(savedPath), "the saved level is opened");
+        level.setLoadDistance(CHUNK_SIZE);
+        loadAround(level, Vector2());
+        Object* crate = findCrate(Vector2(6.f, 6.f));
+        Test::check(crate != nullptr && crate->getPosition() == Vector2(6.f, 6.f) && ObjectManager::getNumberOfObjects() == 8, "the saved level has the changes of the unloaded chunk");
+    }
+    clearObjects();
+
+    std::filesystem::remove(levelPath);
+    std::filesystem::remove(savedPath);
+    return Test::result("LevelStreamer");
+}
@@ -0,0 +1,66 @@
+// checks that casts are cached for objects created with Object::create and with new without resolving types while constructing
+
+#include "Test.hpp"
+#include "ObjectManager.hpp"
+
+class Shape : public virtual Object {};
+class Body : public virtual Object {};
+
+/// @brief created with Object::create
+class Pooled : public Shape, public Body {};
+/// @brief only created with new
+class Allocated : public Shape, public Body {};
+
+/// @brief casts from its constructor while the object is still only a Partial
+class Partial : public virtual Object
+{
+public:
+    inline Partial()
+    {
+        constructingCast = cast<Body>();
+    }
+
+    const Body* constructingCast = nullptr;
+};
+class Complete : public Partial, public Body {};
+
+/// @returns true if the cast to the given type is cached for every object of the most derived type
+template <typename Type, typename Target>
+static bool isCached()
+{
+    return ObjectTypeInfo::get(typeid(Type)).getOffset(ObjectTypeInfo::getTypeID<Target>()) != ObjectTypeInfo::UNKNOWN;
+}
+
+static void nextFrame()
+{
+    ObjectManager::ClearDestroyQueue();
+}
+
+int main()
+{
+    Pooled* pooled = Object::create<Pooled>();
+    Test::check(pooled->cast<Body>() == static_cast<Body*>(pooled), "the cast of a pooled object is correct");
+    Test::check(isCached<Pooled, Body>(), "the cast of a pooled object is cached in the frame it is created in");
+
+    Allocated* allocated = new Allocated();
+    Test::check(allocated->cast<Body>() == static_cast<Body*>(allocated), "the cast of an object created with new is correct while it could still be constructing");
+    Test::check(!isCached<Allocated, Body>(), "the type is not resolved in the frame the object is created in");
+    nextFrame();
+    Test::check(allocated->cast<Body>() == static_cast<Body*>(allocated), "the cast of an object created with new is correct");
+    Test::check(isCached<Allocated, Body>(), "the cast is cached once the object is done constructing");
+    Allocated* second = new Allocated();
+    Test::check(second->cast<Shape>() == static_cast<Shape*>(second), "the cached cast is used for other objects of the type");
+
+    // a later frame so the frame check is what keeps the partial type from being resolved
+    nextFrame();
+    Complete* complete = new Complete();
+    Test::check(complete->constructingCast == nullptr, "the cast from the constructor only sees the constructed part");
+    Test::check(!isCached<Partial, Body>(), "the type is not resolved while constructing");
+    nextFrame();
+    Test::check(complete->cast<Body>() == static_cast<Body*>(complete), "the cast is correct once constructed");
+
+    ObjectManager::destroyAllObjects();
+    nextFrame();
+    nextFrame();
+    return Test::result("ObjectCast");
+}
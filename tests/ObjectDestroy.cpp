@@ -0,0 +1,96 @@
+// checks that a large destroy batch calls every onDestroy on the main thread while its heap memory is freed on the thread pool
+
+#include <thread>
+
+#include "Test.hpp"
+#include "ObjectManager.hpp"
+#include "ThreadPool.hpp"
+
+static int destroyed = 0;
+static bool allOnMainThread = true;
+static std::thread::id mainThread;
+static int parentsAliveInChildDestructor = 0;
+static int ownDeletes = 0;
+
+class Node : public virtual Object
+{
+public:
+    inline Node()
+    {
+        onDestroy([](){
+            destroyed++;
+            allOnMainThread = allOnMainThread && std::this_thread::get_id() == mainThread;
+        });
+    }
+
+    inline ~Node()
+    {
+        // children unlink themselves from the parent so it has to still be alive
+        if (getParentRaw() != nullptr && getParentRaw()->isDestroyQueued())
+            parentsAliveInChildDestructor++;
+    }
+};
+
+/// @brief frees its own memory so the batch should not keep it
+class OwnAllocation : public Node
+{
+public:
+    static inline void* operator new(std::size_t size)
+    {
+        return ::operator new(size);
+    }
+
+    static inline void operator delete(void* memory)
+    {
+        ownDeletes++;
+        ::operator delete(memory);
+    }
+};
+
+static void clearQueue()
+{
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+}
+
+int main()
+{
+    constexpr int ROOTS = 1000;
+    mainThread = std::this_thread::get_id();
+
+    // enough heap objects that their memory is freed on the thread pool
+    std::vector<Object*> roots;
+    for (int i = 0; i < ROOTS; i++)
+    {
+        Object* root = i % 2 == 0 ? static_cast<Object*>(new Node()) : static_cast<Object*>(Object::create<Node>());
+        Node* child = new Node();
+        child->setParent(root);
+        OwnAllocation* own = new OwnAllocation();
+        own->setParent(child);
+        roots.emplace_back(root);
+    }
+    const int total = ROOTS * 3;
+    Test::check(ObjectManager::getNumberOfObjects() == (uint64_t)total, "every object is added");
+
+    for (Object* root: roots)
+    {
+        root->destroy();
+    }
+    clearQueue();
+    ThreadPool::get().wait();
+
+    Test::check(destroyed == total, "onDestroy is called for every object in the batch");
+    Test::check(allOnMainThread, "every onDestroy is called on the main thread");
+    Test::check(parentsAliveInChildDestructor == total - ROOTS, "every child is destructed before its parent");
+    Test::check(ownDeletes == ROOTS, "types with their own operator delete still use it");
+    Test::check(ObjectManager::getNumberOfObjects() == 0, "every object is removed");
+
+    // a small batch and objects deleted outside of a batch are freed right away
+    Node* single = new Node();
+    single->destroy();
+    clearQueue();
+    delete new Node();
+    Test::check(destroyed == total + 1, "onDestroy is called for a small batch");
+
+    return Test::result("ObjectDestroy");
+}
@@ -0,0 +1,38 @@
+#ifndef TEST_HPP
+#define TEST_HPP
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+/// @brief helpers shared by the tests in this folder
+/// @note every test is its own executable built and run with "make test" against the debug objects of the framework
+class Test
+{
+public:
+    /// @brief prints the message and marks the test as failed if the condition is false
+    static inline void check(bool condition, const std::string& message)
+    {
+        if (condition)
+            return;
+        std::printf("FAILED: %s\n", message.c_str());
+        m_failures++;
+    }
+
+    /// @brief prints if the test passed
+    /// @returns the exit code of the test (non zero if any check failed)
+    static inline int result(const std::string& name)
+    {
+        if (m_failures == 0)
+            std::printf("%s: passed\n", name.c_str());
+        else
+            std::printf("%s: %d checks failed\n", name.c_str(), m_failures);
+        return m_failures == 0 ? 0 : 1;
+    }
+
+private:
+    static inline int m_failures = 0;
+};
+
+#endif
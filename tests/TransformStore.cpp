@@ -0,0 +1,56 @@
+// checks that the last global transforms stay with their objects when transforms are removed
+
+#include "Test.hpp"
+#include "ObjectManager.hpp"
+#include "TransformStore.hpp"
+
+static Vector2 lastGlobalPosition(const Object* object)
+{
+    return TransformStore::getLastGlobal(object->getTransformIndex()).position;
+}
+
+/// @brief the transform of an object is only removed once it is freed (the queue it is added to is cleared the frame after)
+static void destroyNow(Object* object)
+{
+    object->destroy();
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+}
+
+int main()
+{
+    Object* parent = new Object();
+    parent->setPosition(10.f, 0.f);
+    Object* removed = new Object();
+    removed->setPosition(1.f, 0.f);
+    Object* child = new Object();
+    child->setParent(parent);
+    child->setPosition(15.f, 5.f);
+    TransformStore::updateGlobalTransforms();
+
+    // moving after the update should not show in the last global transforms
+    child->setPosition(100.f, 100.f);
+    // the last transform (the child) is moved into the index of the removed one
+    std::uint32_t index = removed->getTransformIndex();
+    destroyNow(removed);
+    Test::check(child->getTransformIndex() == index, "the last transform is moved into the removed index");
+    Test::check(lastGlobalPosition(child) == Vector2(25.f, 5.f), "the moved transform keeps its last global transform");
+    Test::check(lastGlobalPosition(parent) == Vector2(10.f, 0.f), "other transforms keep their last global transform");
+
+    // added after the last update so the local transform is returned instead of the stale global of the removed child
+    Object* added = new Object();
+    added->setPosition(7.f, 0.f);
+    destroyNow(child);
+    Object* other = new Object();
+    other->setPosition(3.f, 0.f);
+    Test::check(lastGlobalPosition(added) == Vector2(7.f, 0.f), "a transform moved before it was updated returns its local transform");
+    Test::check(lastGlobalPosition(other) == Vector2(3.f, 0.f), "a transform added in a removed index returns its local transform");
+
+    TransformStore::updateGlobalTransforms();
+    Test::check(lastGlobalPosition(added) == Vector2(7.f, 0.f) && lastGlobalPosition(other) == Vector2(3.f, 0.f), "the global transforms are updated after removing");
+
+    ObjectManager::destroyAllObjects();
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+    return Test::result("TransformStore");
+}
@@ -0,0 +1,96 @@
+// checks that objects are only kept in the lists of the update phases their type overrides
+
+#include "Test.hpp"
+#include "ObjectManager.hpp"
+#include "UpdateInterface.hpp"
+#include "UpdateManager.hpp"
+
+static int updates = 0;
+static int lateUpdates = 0;
+
+/// @brief only overrides Update
+class Mover : public UpdateInterface
+{
+public:
+    inline void Update(float) override
+    {
+        updates++;
+    }
+};
+
+/// @brief inherits the Update override of Mover and overrides nothing itself
+class FastMover : public Mover {};
+
+/// @brief overrides LateUpdate and calls the default from it
+class Follower : public UpdateInterface
+{
+public:
+    inline void LateUpdate(float deltaTime) override
+    {
+        lateUpdates++;
+        UpdateInterface::LateUpdate(deltaTime);
+    }
+};
+
+/// @brief overrides nothing
+class Idle : public UpdateInterface {};
+/// @brief overrides nothing and is only created with "new"
+class Unregistered : public UpdateInterface {};
+/// @brief overrides nothing and is registered before it is created with "new"
+class RegisteredIdle : public UpdateInterface {};
+
+static std::size_t count(UpdateInterface::Phase phase)
+{
+    return UpdateManager::getNumberOfActiveObjects(phase);
+}
+
+static void clearObjects()
+{
+    ObjectManager::destroyAllObjects();
+    ObjectManager::ClearDestroyQueue();
+    ObjectManager::ClearDestroyQueue();
+}
+
+int main()
+{
+    using Phase = UpdateInterface::Phase;
+
+    // the phases are known from the static type, nothing has to be called first
+    Object::create<Mover>();
+    Object::create<FastMover>();
+    Object::create<Follower>();
+    Object::create<Idle>();
+    Test::check(count(Phase::Update) == 4 && count(Phase::LateUpdate) == 4 && count(Phase::FixedUpdate) == 4, "objects are listed for every phase until their type is resolved");
+
+    // the first phase resolves the type of every object in its lists before any of them are updated
+    UpdateManager::Update(0.f);
+    Test::check(updates == 2, "Update is called for the types that override it (and inherit the override)");
+    Test::check(count(Phase::Update) == 2, "only the objects that override Update stay in the update list");
+    Test::check(count(Phase::LateUpdate) == 1, "only the object that overrides LateUpdate stays in the late update list before late update is called");
+    Test::check(count(Phase::FixedUpdate) == 0, "no object stays in the fixed update list");
+
+    UpdateManager::LateUpdate(0.f);
+    UpdateManager::LateUpdate(0.f);
+    Test::check(lateUpdates == 2 && count(Phase::LateUpdate) == 1, "an override that calls the default stays in the late update list");
+    clearObjects();
+
+    // objects created with new are only resolved if their type was registered (or created with Object::create before)
+    new Unregistered();
+    new Idle();
+    UpdateInterface::registerType<RegisteredIdle>();
+    new RegisteredIdle();
+    UpdateManager::Update(0.f);
+    Test::check(count(Phase::Update) == 1 && count(Phase::LateUpdate) == 1 && count(Phase::FixedUpdate) == 1,
+                "only the object of the type that was never registered stays in every list");
+    clearObjects();
+
+    // disabled objects are not added back to the phases they do not override
+    Mover* mover = Object::create<Mover>();
+    UpdateManager::Update(0.f);
+    mover->setEnabled(false);
+    mover->setEnabled(true);
+    Test::check(count(Phase::Update) == 1 && count(Phase::LateUpdate) == 0 && count(Phase::FixedUpdate) == 0, "enabling an object only lists it for the phases it overrides");
+    clearObjects();
+
+    return Test::result("UpdateInterface");
+}